@@ -0,0 +1,163 @@
+/*
+ * Copyright 2025 Aethernet Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "alloc_counter.h"
+
+#include <new>
+#include <atomic>
+#include <cstdlib>
+
+#if defined _WIN32
+#  include <malloc.h>
+#endif
+
+namespace {
+std::atomic<std::uint64_t> allocation_count{0};
+std::atomic<std::uint64_t> free_count{0};
+std::atomic<std::uint64_t> library_allocation_count{0};
+// constant initialized, so operator new may read it on any thread at any time
+thread_local AllocationScope::Owner current_owner =
+    AllocationScope::Owner::kApplication;
+
+void* Counted(void* ptr) noexcept {
+  if (ptr != nullptr) {
+    allocation_count.fetch_add(1, std::memory_order_relaxed);
+    if (current_owner == AllocationScope::Owner::kLibrary) {
+      library_allocation_count.fetch_add(1, std::memory_order_relaxed);
+    }
+  }
+  return ptr;
+}
+
+void* CountedAlloc(std::size_t size) noexcept {
+  // malloc(0) may return nullptr, but operator new must not
+  return Counted(std::malloc((size == 0) ? 1 : size));
+}
+
+void* CountedAlloc(std::size_t size, std::align_val_t alignment) noexcept {
+  auto align = static_cast<std::size_t>(alignment);
+  // aligned_alloc takes only sizes which are a multiple of the alignment
+  auto aligned_size = (size == 0) ? align : (size + align - 1) / align * align;
+#if defined _WIN32
+  return Counted(_aligned_malloc(aligned_size, align));
+#else
+  return Counted(std::aligned_alloc(align, aligned_size));
+#endif
+}
+
+template <typename... TAlign>
+void* CountedAllocOrThrow(std::size_t size, TAlign... alignment) {
+  auto* ptr = CountedAlloc(size, alignment...);
+  if (ptr == nullptr) {
+    throw std::bad_alloc{};
+  }
+  return ptr;
+}
+
+void CountedFree(void* ptr) noexcept {
+  if (ptr != nullptr) {
+    free_count.fetch_add(1, std::memory_order_relaxed);
+  }
+  std::free(ptr);
+}
+
+void CountedFree(void* ptr, std::align_val_t) noexcept {
+#if defined _WIN32
+  // memory of _aligned_malloc must not be given to free
+  if (ptr != nullptr) {
+    free_count.fetch_add(1, std::memory_order_relaxed);
+  }
+  _aligned_free(ptr);
+#else
+  CountedFree(ptr);
+#endif
+}
+}  // namespace
+
+std::uint64_t AllocationCount() {
+  return allocation_count.load(std::memory_order_relaxed);
+}
+
+std::uint64_t LiveAllocationCount() {
+  return allocation_count.load(std::memory_order_relaxed) -
+         free_count.load(std::memory_order_relaxed);
+}
+
+std::uint64_t LibraryAllocationCount() {
+  return library_allocation_count.load(std::memory_order_relaxed);
+}
+
+AllocationScope::AllocationScope(Owner owner) : previous_owner_{current_owner} {
+  current_owner = owner;
+}
+
+AllocationScope::~AllocationScope() { current_owner = previous_owner_; }
+
+void* operator new(std::size_t size) { return CountedAllocOrThrow(size); }
+void* operator new[](std::size_t size) { return CountedAllocOrThrow(size); }
+void* operator new(std::size_t size, std::nothrow_t const&) noexcept {
+  return CountedAlloc(size);
+}
+void* operator new[](std::size_t size, std::nothrow_t const&) noexcept {
+  return CountedAlloc(size);
+}
+void* operator new(std::size_t size, std::align_val_t alignment) {
+  return CountedAllocOrThrow(size, alignment);
+}
+void* operator new[](std::size_t size, std::align_val_t alignment) {
+  return CountedAllocOrThrow(size, alignment);
+}
+void* operator new(std::size_t size, std::align_val_t alignment,
+                   std::nothrow_t const&) noexcept {
+  return CountedAlloc(size, alignment);
+}
+void* operator new[](std::size_t size, std::align_val_t alignment,
+                     std::nothrow_t const&) noexcept {
+  return CountedAlloc(size, alignment);
+}
+
+void operator delete(void* ptr) noexcept { CountedFree(ptr); }
+void operator delete[](void* ptr) noexcept { CountedFree(ptr); }
+void operator delete(void* ptr, std::size_t) noexcept { CountedFree(ptr); }
+void operator delete[](void* ptr, std::size_t) noexcept { CountedFree(ptr); }
+void operator delete(void* ptr, std::nothrow_t const&) noexcept {
+  CountedFree(ptr);
+}
+void operator delete[](void* ptr, std::nothrow_t const&) noexcept {
+  CountedFree(ptr);
+}
+void operator delete(void* ptr, std::align_val_t alignment) noexcept {
+  CountedFree(ptr, alignment);
+}
+void operator delete[](void* ptr, std::align_val_t alignment) noexcept {
+  CountedFree(ptr, alignment);
+}
+void operator delete(void* ptr, std::size_t,
+                     std::align_val_t alignment) noexcept {
+  CountedFree(ptr, alignment);
+}
+void operator delete[](void* ptr, std::size_t,
+                       std::align_val_t alignment) noexcept {
+  CountedFree(ptr, alignment);
+}
+void operator delete(void* ptr, std::align_val_t alignment,
+                     std::nothrow_t const&) noexcept {
+  CountedFree(ptr, alignment);
+}
+void operator delete[](void* ptr, std::align_val_t alignment,
+                       std::nothrow_t const&) noexcept {
+  CountedFree(ptr, alignment);
+}
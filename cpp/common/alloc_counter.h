@@ -0,0 +1,61 @@
+/*
+ * Copyright 2025 Aethernet Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef COMMON_ALLOC_COUNTER_H_
+#define COMMON_ALLOC_COUNTER_H_
+
+#include <cstdint>
+
+/**
+ * \brief Number of heap allocations made by the process so far.
+ * Counted by the replaced global operator new, so it includes the allocations
+ * made by the aether library and the standard library.
+ */
+std::uint64_t AllocationCount();
+/**
+ * \brief Number of heap allocations not freed yet.
+ */
+std::uint64_t LiveAllocationCount();
+/**
+ * \brief Number of heap allocations made inside a library AllocationScope.
+ * The rest of AllocationCount is the application's own.
+ */
+std::uint64_t LibraryAllocationCount();
+
+/**
+ * \brief Attributes the allocations of the current thread while it is alive.
+ * A scope of the library wraps each call into the library, and the
+ * application's callbacks the library calls open their own scope back, so
+ * the allocations made on behalf of each side are counted apart.
+ */
+class AllocationScope {
+ public:
+  enum class Owner : std::uint8_t {
+    kApplication,
+    kLibrary,
+  };
+
+  explicit AllocationScope(Owner owner);
+  ~AllocationScope();
+
+  AllocationScope(AllocationScope const&) = delete;
+  AllocationScope& operator=(AllocationScope const&) = delete;
+
+ private:
+  Owner previous_owner_;
+};
+
+#endif  // COMMON_ALLOC_COUNTER_H_
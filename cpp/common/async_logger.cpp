@@ -0,0 +1,125 @@
+/*
+ * Copyright 2025 Aethernet Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "async_logger.h"
+
+#include <chrono>
+#include <iostream>
+#include <algorithm>
+
+#if defined __linux__
+#  include <pthread.h>
+#  include <sched.h>
+#elif defined _WIN32
+#  include <windows.h>
+#endif
+
+namespace {
+// how long the drain loop sleeps when there is nothing to write
+constexpr auto kIdleInterval = std::chrono::milliseconds{10};
+
+void Sleep(std::chrono::milliseconds duration) {
+#if defined ESP_PLATFORM
+  vTaskDelay(std::max(pdMS_TO_TICKS(duration.count()), TickType_t{1}));
+#else
+  std::this_thread::sleep_for(duration);
+#endif
+}
+
+#if !defined ESP_PLATFORM
+void LowerThreadPriority() {
+#  if defined __linux__
+  sched_param param{};
+  pthread_setschedparam(pthread_self(), SCHED_IDLE, &param);
+#  elif defined _WIN32
+  SetThreadPriority(GetCurrentThread(), THREAD_PRIORITY_LOWEST);
+#  endif
+}
+#endif
+}  // namespace
+
+#if defined ESP_PLATFORM
+AsyncLogger::AsyncLogger() {
+  xTaskCreate(&AsyncLogger::DrainTask, "async_log", 4096, this,
+              tskIDLE_PRIORITY + 1, nullptr);
+}
+
+AsyncLogger::~AsyncLogger() {
+  stop_.store(true, std::memory_order_release);
+  while (!stopped_.load(std::memory_order_acquire)) {
+    Sleep(kIdleInterval);
+  }
+}
+
+void AsyncLogger::DrainTask(void* logger) {
+  auto* self = static_cast<AsyncLogger*>(logger);
+  self->Drain();
+  self->stopped_.store(true, std::memory_order_release);
+  vTaskDelete(nullptr);
+}
+#else
+AsyncLogger::AsyncLogger() : thread_{[this]() { Drain(); }} {}
+
+AsyncLogger::~AsyncLogger() {
+  stop_.store(true, std::memory_order_release);
+  thread_.join();
+}
+#endif
+
+void AsyncLogger::Flush() {
+  while (tail_.load(std::memory_order_acquire) !=
+         head_.load(std::memory_order_relaxed)) {
+    Sleep(std::chrono::milliseconds{1});
+  }
+}
+
+void AsyncLogger::Drain() {
+#if !defined ESP_PLATFORM
+  // the task on ESP32 is created with a low priority
+  LowerThreadPriority();
+#endif
+  while (!stop_.load(std::memory_order_acquire)) {
+    if (!WriteRecords()) {
+      Sleep(kIdleInterval);
+    }
+  }
+  WriteRecords();
+}
+
+bool AsyncLogger::WriteRecords() {
+  auto tail = tail_.load(std::memory_order_relaxed);
+  auto head = head_.load(std::memory_order_acquire);
+  if (tail == head) {
+    return false;
+  }
+  for (; tail != head; ++tail) {
+    auto& slot = slots_[tail % kSlotCount];
+    slot.write(slot.storage, std::cout);
+    // the slot is free for the producer only after the record is destroyed
+    tail_.store(tail + 1, std::memory_order_release);
+  }
+  auto dropped_count = dropped_count_.exchange(0, std::memory_order_relaxed);
+  if (dropped_count > 0) {
+    std::cout << ">> " << dropped_count << " log records dropped\n";
+  }
+  std::cout.flush();
+  return true;
+}
+
+AsyncLogger& Logger() {
+  static AsyncLogger logger;
+  return logger;
+}
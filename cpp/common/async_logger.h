@@ -0,0 +1,127 @@
+/*
+ * Copyright 2025 Aethernet Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef COMMON_ASYNC_LOGGER_H_
+#define COMMON_ASYNC_LOGGER_H_
+
+#include <new>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <utility>
+#include <type_traits>
+
+#if defined ESP_PLATFORM
+#  include <freertos/FreeRTOS.h>
+#  include <freertos/task.h>
+#else
+#  include <thread>
+#endif
+
+/**
+ * \brief Console logger which keeps formatting and output off the caller.
+ * Log places the formatting callable with its captures into a slot of a
+ * lock-free single producer ring, so the caller neither formats nor blocks on
+ * the console and makes no heap allocations. A low priority thread calls the
+ * callables and writes the text to std::cout, on ESP32 it is a FreeRTOS task
+ * just above the idle priority, so a slow UART console never stalls the
+ * application loop. If the ring is full the record is dropped and counted,
+ * the caller is never blocked, and the count is written with the next records.
+ * Log must be called from one thread at a time, and callables must capture by
+ * value, a string_view only of text which outlives the record.
+ */
+class AsyncLogger {
+ public:
+#if defined ESP_PLATFORM
+  static constexpr std::size_t kSlotCount = 16;
+  static constexpr std::size_t kRecordSize = 48;
+#else
+  static constexpr std::size_t kSlotCount = 256;
+  static constexpr std::size_t kRecordSize = 112;
+#endif
+
+  AsyncLogger();
+  /**
+   * \brief Write all the logged records and stop the thread.
+   */
+  ~AsyncLogger();
+
+  AsyncLogger(AsyncLogger const&) = delete;
+  AsyncLogger& operator=(AsyncLogger const&) = delete;
+
+  /**
+   * \brief Log the string returned by format().
+   */
+  template <typename TFormat>
+  void Log(TFormat&& format) {
+    using Record = std::decay_t<TFormat>;
+    static_assert(sizeof(Record) <= kRecordSize,
+                  "Log record captures are too large");
+    static_assert(alignof(Record) <= alignof(std::max_align_t),
+                  "Log record captures are over aligned");
+
+    auto head = head_.load(std::memory_order_relaxed);
+    if ((head - tail_.load(std::memory_order_acquire)) == kSlotCount) {
+      dropped_count_.fetch_add(1, std::memory_order_relaxed);
+      return;
+    }
+    auto& slot = slots_[head % kSlotCount];
+    new (slot.storage) Record(std::forward<TFormat>(format));
+    slot.write = [](void* storage, std::ostream& os) {
+      auto* record = std::launder(static_cast<Record*>(storage));
+      os << (*record)();
+      record->~Record();
+    };
+    head_.store(head + 1, std::memory_order_release);
+  }
+
+  /**
+   * \brief Wait until all the records logged so far are written.
+   */
+  void Flush();
+
+ private:
+  struct Slot {
+    void (*write)(void* storage, std::ostream& os);
+    alignas(std::max_align_t) unsigned char storage[kRecordSize];
+  };
+
+  void Drain();
+  bool WriteRecords();
+#if defined ESP_PLATFORM
+  static void DrainTask(void* logger);
+#endif
+
+  std::array<Slot, kSlotCount> slots_;
+  std::atomic<std::size_t> head_{0};
+  std::atomic<std::size_t> tail_{0};
+  std::atomic<std::uint64_t> dropped_count_{0};
+  std::atomic<bool> stop_{false};
+#if defined ESP_PLATFORM
+  std::atomic<bool> stopped_{false};
+#else
+  std::thread thread_;
+#endif
+};
+
+/**
+ * \brief The logger shared by the whole application.
+ */
+AsyncLogger& Logger();
+
+#endif  // COMMON_ASYNC_LOGGER_H_
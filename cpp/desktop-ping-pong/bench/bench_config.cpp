@@ -0,0 +1,152 @@
+/*
+ * Copyright 2025 Aethernet Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "bench/bench_config.h"
+
+#include <charconv>
+#include <string_view>
+
+namespace {
+template <typename T>
+bool ParseNumber(std::string_view str, T& value) {
+  auto [ptr, ec] = std::from_chars(str.data(), str.data() + str.size(), value);
+  return (ec == std::errc{}) && (ptr == str.data() + str.size());
+}
+
+// comma separated list of positive numbers
+template <typename T>
+bool ParseList(std::string_view str, std::vector<T>& values) {
+  values.clear();
+  while (!str.empty()) {
+    auto comma_pos = str.find(',');
+    T value{};
+    if (!ParseNumber(str.substr(0, comma_pos), value) || (value == T{})) {
+      return false;
+    }
+    values.push_back(value);
+    str = (comma_pos == std::string_view::npos) ? std::string_view{}
+                                                : str.substr(comma_pos + 1);
+  }
+  return !values.empty();
+}
+}  // namespace
+
+std::optional<BenchConfig> ParseBenchConfig(int argc, char const* argv[]) {
+  BenchConfig config;
+  for (int i = 1; i < argc; ++i) {
+    auto arg = std::string_view{argv[i]};
+    auto eq_pos = arg.find('=');
+    auto key = arg.substr(0, eq_pos);
+    auto value = (eq_pos == std::string_view::npos) ? std::string_view{}
+                                                    : arg.substr(eq_pos + 1);
+
+    bool ok = true;
+    if (key == "--latency") {
+      config.mode = BenchMode::kLatency;
+    } else if (key == "--rate") {
+      config.mode = BenchMode::kRate;
+      ok = value.empty() || ParseList(value, config.rates);
+    } else if (key == "--throughput") {
+      config.mode = BenchMode::kThroughput;
+      ok = value.empty() || ParseList(value, config.payload_sizes);
+    } else if (key == "--pairs") {
+      config.mode = BenchMode::kPairs;
+      ok = value.empty() || ParseList(value, config.pair_counts);
+    } else if (key == "--threads") {
+      config.mode = BenchMode::kPairs;
+      ok = ParseNumber(value, config.thread_count) && (config.thread_count > 0);
+    } else if (key == "--log") {
+      if (value == "sync") {
+        config.log_mode = LogMode::kSync;
+      } else if (value == "async") {
+        config.log_mode = LogMode::kAsync;
+      } else {
+        ok = false;
+      }
+    } else if (key == "--output") {
+      config.output_path = value;
+      ok = !value.empty();
+    } else if (key == "--baseline") {
+      config.baseline_path = value;
+      ok = !value.empty();
+    } else if (key == "--threshold") {
+      ok = ParseNumber(value, config.regression_threshold) &&
+           (config.regression_threshold >= 0);
+    } else if (key == "--stage-bytes") {
+      ok = ParseNumber(value, config.stage_bytes) && (config.stage_bytes > 0);
+    } else if (key == "--window") {
+      ok = ParseNumber(value, config.throughput_window) &&
+           (config.throughput_window > 0);
+    } else if (key == "--duration") {
+      ok = ParseNumber(value, config.stage_duration) &&
+           (config.stage_duration > 0);
+    } else if (key == "--count") {
+      ok = ParseNumber(value, config.message_count) &&
+           (config.message_count > 0);
+    } else if (key == "--warmup") {
+      ok = ParseNumber(value, config.warmup_count);
+    } else if (key == "--inflight") {
+      ok = ParseList(value, config.inflight_depths);
+    } else {
+      ok = false;
+    }
+    if (!ok) {
+      return std::nullopt;
+    }
+  }
+  // per message output is measured in latency mode only
+  if ((config.log_mode != LogMode::kNone) &&
+      (config.mode != BenchMode::kLatency)) {
+    return std::nullopt;
+  }
+  // a later mode option must not leave the threads of the pairs mode set
+  if ((config.thread_count > 1) && (config.mode != BenchMode::kPairs)) {
+    return std::nullopt;
+  }
+  // the regular example has no results
+  if ((config.mode == BenchMode::kDemo) &&
+      (!config.output_path.empty() || !config.baseline_path.empty())) {
+    return std::nullopt;
+  }
+  return config;
+}
+
+void PrintBenchUsage(std::ostream& os, char const* program) {
+  os << "Usage: " << program << " [options]\n"
+     << "Without options runs the regular ping-pong example.\n"
+     << "  --latency         measure round trip latency histogram\n"
+     << "  --count=N         number of measured round trips (default 10000)\n"
+     << "  --warmup=N        round trips excluded from report (default 100)\n"
+     << "  --inflight=K,..   pings in flight, a stage per depth (default 1)\n"
+     << "  --rate[=R,..]     open-loop load at R msg/s, a stage per rate\n"
+     << "                    (default 10,100,1000)\n"
+     << "  --duration=S      seconds per rate or pairs stage (default 10)\n"
+     << "  --throughput[=S,..]\n"
+     << "                    bulk transfer, a stage per payload size in bytes\n"
+     << "                    (default 16 B to 256 KiB)\n"
+     << "  --stage-bytes=N   bytes sent per throughput stage (default 16 MiB)\n"
+     << "  --window=N        messages in flight for throughput (default 32)\n"
+     << "  --pairs[=N,..]    N client pairs at once, a stage per count\n"
+     << "                    (default 10,100)\n"
+     << "  --threads=K       K applications on K pinned threads, each with\n"
+     << "                    its own pairs (default 1)\n"
+     << "  --log=sync|async  print each latency round trip directly or\n"
+     << "                    through the asynchronous logger\n"
+     << "  --output=FILE     write benchmark results as JSON or CSV\n"
+     << "  --baseline=FILE   compare results with CSV of a previous run,\n"
+     << "                    exit with code 2 on regression\n"
+     << "  --threshold=P     allowed regression in percent (default 10)\n";
+}
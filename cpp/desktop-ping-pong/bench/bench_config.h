@@ -0,0 +1,80 @@
+/*
+ * Copyright 2025 Aethernet Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef BENCH_BENCH_CONFIG_H_
+#define BENCH_BENCH_CONFIG_H_
+
+#include <string>
+#include <vector>
+#include <cstddef>
+#include <ostream>
+#include <optional>
+
+enum class BenchMode {
+  kDemo,        // regular ping-pong example
+  kLatency,     // round trip latency histogram
+  kRate,        // open-loop constant rate load
+  kThroughput,  // bulk transfer payload size sweep
+  kPairs,       // many client pairs in one application
+};
+
+enum class LogMode {
+  kNone,   // no output per message
+  kSync,   // print each round trip to std::cout
+  kAsync,  // log each round trip through the AsyncLogger
+};
+
+struct BenchConfig {
+  BenchMode mode = BenchMode::kDemo;
+  // number of measured round trips
+  std::size_t message_count = 10000;
+  // number of round trips excluded from the report
+  std::size_t warmup_count = 100;
+  // pipelining depths, each one is measured as a separate stage
+  std::vector<std::size_t> inflight_depths = {1};
+  // target message rates in msg/s for open-loop mode, a stage per rate
+  std::vector<double> rates = {10, 100, 1000};
+  // duration of each open-loop or pairs stage in seconds
+  double stage_duration = 10;
+  // payload sizes in bytes for throughput mode, a stage per size
+  std::vector<std::size_t> payload_sizes = {16,   64,    256,   1024,
+                                            4096, 16384, 65536, 262144};
+  // bytes transferred in each throughput stage
+  std::size_t stage_bytes = 16 * 1024 * 1024;
+  // unacknowledged messages in flight in throughput mode
+  std::size_t throughput_window = 32;
+  // numbers of simultaneously active client pairs, a stage per count
+  std::vector<std::size_t> pair_counts = {10, 100};
+  // independent applications, each on its own thread with its own pairs
+  std::size_t thread_count = 1;
+  // how latency mode prints each round trip
+  LogMode log_mode = LogMode::kNone;
+  // file to write results to, JSON if it ends with .json, CSV otherwise
+  std::string output_path;
+  // CSV results of a previous run to compare with
+  std::string baseline_path;
+  // percent a metric may get worse than the baseline without failing
+  double regression_threshold = 10;
+};
+
+/**
+ * \brief Parse command line arguments in form --key=value.
+ * Returns std::nullopt on unknown or malformed argument.
+ */
+std::optional<BenchConfig> ParseBenchConfig(int argc, char const* argv[]);
+void PrintBenchUsage(std::ostream& os, char const* program);
+
+#endif  // BENCH_BENCH_CONFIG_H_
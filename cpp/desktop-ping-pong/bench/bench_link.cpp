@@ -0,0 +1,40 @@
+/*
+ * Copyright 2025 Aethernet Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "bench/bench_link.h"
+
+#include "alloc_counter.h"
+
+BenchLink::BenchLink(ae::AetherApp& aether_app, ae::Client::ptr client,
+                     ae::Uid bobs_uid)
+    : client_{std::move(client)},
+      p2pstream_{aether_app, client_.Load(), bobs_uid,
+                 client_->message_stream_manager().CreatePort(bobs_uid)},
+      receive_data_sub_{p2pstream_.out_data_event().Subscribe(
+          ae::MethodPtr<&BenchLink::DataReceived>{this})} {}
+
+void BenchLink::Write(ae::DataBuffer&& data) {
+  auto library_scope = AllocationScope{AllocationScope::Owner::kLibrary};
+  p2pstream_.Write(std::move(data));
+}
+
+void BenchLink::DataReceived(ae::DataBuffer const& data) {
+  // called from the library's update
+  auto app_scope = AllocationScope{AllocationScope::Owner::kApplication};
+  if (receiver_) {
+    receiver_(data);
+  }
+}
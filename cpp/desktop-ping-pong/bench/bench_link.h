@@ -0,0 +1,49 @@
+/*
+ * Copyright 2025 Aethernet Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef BENCH_BENCH_LINK_H_
+#define BENCH_BENCH_LINK_H_
+
+#include <functional>
+
+#include "aether/all.h"
+
+/**
+ * \brief Alice's end of the P2pStream to Bob used by the benchmarks.
+ * Bob answers each message with its header. The allocations made by the
+ * stream are counted as the library's (\see AllocationScope).
+ */
+class BenchLink {
+ public:
+  using Receiver = std::function<void(ae::DataBuffer const& data)>;
+
+  BenchLink(ae::AetherApp& aether_app, ae::Client::ptr client,
+            ae::Uid bobs_uid);
+
+  void Write(ae::DataBuffer&& data);
+
+  void set_receiver(Receiver receiver) { receiver_ = std::move(receiver); }
+
+ private:
+  void DataReceived(ae::DataBuffer const& data);
+
+  ae::Client::ptr client_;
+  ae::P2pStream p2pstream_;
+  ae::Subscription receive_data_sub_;
+  Receiver receiver_;
+};
+
+#endif  // BENCH_BENCH_LINK_H_
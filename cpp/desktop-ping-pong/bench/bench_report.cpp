@@ -0,0 +1,38 @@
+/*
+ * Copyright 2025 Aethernet Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "bench/bench_report.h"
+
+#include <iostream>
+
+#include "aether/all.h"
+
+double ToMicros(std::chrono::nanoseconds value) {
+  return std::chrono::duration<double, std::micro>{value}.count();
+}
+
+void PrintLatencyReport(LatencyHistogram const& histogram) {
+  std::cout << ae::Format("  min    {:>12.1f} us\n", ToMicros(histogram.min()));
+  std::cout << ae::Format("  mean   {:>12.1f} us\n",
+                          ToMicros(histogram.mean()));
+  for (auto percentile : {50.0, 90.0, 99.0, 99.9}) {
+    std::cout << ae::Format("  p{:<5} {:>12.1f} us\n", percentile,
+                            ToMicros(histogram.Percentile(percentile)));
+  }
+  std::cout << ae::Format("  max    {:>12.1f} us\n", ToMicros(histogram.max()));
+  std::cout << ae::Format("  jitter {:>12.1f} us\n",
+                          ToMicros(histogram.jitter()));
+}
@@ -0,0 +1,31 @@
+/*
+ * Copyright 2025 Aethernet Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef BENCH_BENCH_REPORT_H_
+#define BENCH_BENCH_REPORT_H_
+
+#include <chrono>
+
+#include "bench/latency_histogram.h"
+
+double ToMicros(std::chrono::nanoseconds value);
+
+/**
+ * \brief Print min, mean, percentiles, max and jitter to std::cout.
+ */
+void PrintLatencyReport(LatencyHistogram const& histogram);
+
+#endif  // BENCH_BENCH_REPORT_H_
@@ -0,0 +1,253 @@
+/*
+ * Copyright 2025 Aethernet Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "bench/bench_results.h"
+
+#include <cmath>
+#include <fstream>
+#include <charconv>
+#include <iostream>
+#include <algorithm>
+
+#include "aether/all.h"
+
+#include "bench/cpu_time.h"
+#include "bench/bench_report.h"
+
+namespace {
+std::string_view GoalName(MetricGoal goal) {
+  switch (goal) {
+    case MetricGoal::kNone:
+      return "none";
+    case MetricGoal::kLower:
+      return "lower";
+    case MetricGoal::kHigher:
+      return "higher";
+  }
+  return "none";
+}
+
+std::optional<MetricGoal> ParseGoal(std::string_view str) {
+  for (auto goal :
+       {MetricGoal::kNone, MetricGoal::kLower, MetricGoal::kHigher}) {
+    if (GoalName(goal) == str) {
+      return goal;
+    }
+  }
+  return std::nullopt;
+}
+
+bool EndsWith(std::string_view str, std::string_view suffix) {
+  return (str.size() >= suffix.size()) &&
+         (str.substr(str.size() - suffix.size()) == suffix);
+}
+
+void WriteCsv(BenchResults const& results, std::ostream& os) {
+  os << "name,value,unit,goal\n";
+  for (auto const& metric : results.metrics()) {
+    os << ae::Format("{},{},{},{}\n", metric.name, metric.value, metric.unit,
+                     GoalName(metric.goal));
+  }
+}
+
+void WriteJson(BenchResults const& results, std::ostream& os) {
+  os << "{\n  \"metrics\": [";
+  bool first = true;
+  for (auto const& metric : results.metrics()) {
+    os << (first ? "\n" : ",\n");
+    first = false;
+    // JSON has no NaN and infinity
+    auto value = std::isfinite(metric.value) ? ae::Format("{}", metric.value)
+                                             : std::string{"null"};
+    os << ae::Format(
+        "    {{\"name\": \"{}\", \"value\": {}, \"unit\": \"{}\", \"goal\": "
+        "\"{}\"}}",
+        metric.name, value, metric.unit, GoalName(metric.goal));
+  }
+  os << "\n  ]\n}\n";
+}
+
+// split a line into exactly count comma separated fields
+bool SplitFields(std::string_view line, std::string_view* fields,
+                 std::size_t count) {
+  for (std::size_t i = 0; i < count; ++i) {
+    auto comma_pos = line.find(',');
+    if ((comma_pos == std::string_view::npos) != (i == count - 1)) {
+      return false;
+    }
+    fields[i] = line.substr(0, comma_pos);
+    line = (comma_pos == std::string_view::npos) ? std::string_view{}
+                                                 : line.substr(comma_pos + 1);
+  }
+  return true;
+}
+
+bool IsWorse(Metric const& metric, double value, double threshold) {
+  if ((metric.goal == MetricGoal::kNone) || !std::isfinite(metric.value)) {
+    return false;
+  }
+  if (!std::isfinite(value)) {
+    // the gated metric could not be measured in this run
+    return true;
+  }
+  if (metric.value == 0) {
+    // nothing to scale the threshold by, any growth of a lower-is-better
+    // metric is a regression
+    return (metric.goal == MetricGoal::kLower) && (value > 0);
+  }
+  auto change = (value - metric.value) / std::abs(metric.value) * 100.0;
+  return (metric.goal == MetricGoal::kLower) ? (change > threshold)
+                                             : (change < -threshold);
+}
+}  // namespace
+
+void BenchResults::Add(std::string name, double value, std::string unit,
+                       MetricGoal goal) {
+  metrics_.push_back(Metric{std::move(name), value, std::move(unit), goal});
+}
+
+void BenchResults::AddLatency(std::string const& prefix,
+                              LatencyHistogram const& histogram) {
+  Add(prefix + ".count", static_cast<double>(histogram.count()), "",
+      MetricGoal::kNone);
+  // the extremes and the far tail of a run over the network are too noisy to
+  // be compared with a percent threshold, so only the center and p99 are gated
+  Add(prefix + ".min", ToMicros(histogram.min()), "us", MetricGoal::kNone);
+  Add(prefix + ".mean", ToMicros(histogram.mean()), "us", MetricGoal::kLower);
+  Add(prefix + ".p50", ToMicros(histogram.Percentile(50.0)), "us",
+      MetricGoal::kLower);
+  Add(prefix + ".p90", ToMicros(histogram.Percentile(90.0)), "us",
+      MetricGoal::kNone);
+  Add(prefix + ".p99", ToMicros(histogram.Percentile(99.0)), "us",
+      MetricGoal::kLower);
+  Add(prefix + ".p99_9", ToMicros(histogram.Percentile(99.9)), "us",
+      MetricGoal::kNone);
+  Add(prefix + ".max", ToMicros(histogram.max()), "us", MetricGoal::kNone);
+  Add(prefix + ".jitter", ToMicros(histogram.jitter()), "us",
+      MetricGoal::kNone);
+}
+
+Metric const* BenchResults::Find(std::string_view name) const {
+  auto it =
+      std::find_if(std::begin(metrics_), std::end(metrics_),
+                   [&](auto const& metric) { return metric.name == name; });
+  return (it != std::end(metrics_)) ? &*it : nullptr;
+}
+
+bool WriteBenchResults(BenchResults const& results, std::string const& path) {
+  auto file = std::ofstream{path};
+  if (!file) {
+    return false;
+  }
+  if (EndsWith(path, ".json")) {
+    WriteJson(results, file);
+  } else {
+    WriteCsv(results, file);
+  }
+  return static_cast<bool>(file);
+}
+
+std::optional<BenchResults> ReadBenchResults(std::string const& path) {
+  auto file = std::ifstream{path};
+  if (!file) {
+    return std::nullopt;
+  }
+  BenchResults results;
+  std::string line;
+  // skip the header
+  std::getline(file, line);
+  while (std::getline(file, line)) {
+    if (line.empty()) {
+      continue;
+    }
+    std::string_view fields[4];
+    if (!SplitFields(line, fields, 4)) {
+      return std::nullopt;
+    }
+    double value{};
+    auto [ptr, ec] = std::from_chars(
+        fields[1].data(), fields[1].data() + fields[1].size(), value);
+    auto goal = ParseGoal(fields[3]);
+    if ((ec != std::errc{}) || !goal) {
+      return std::nullopt;
+    }
+    results.Add(std::string{fields[0]}, value, std::string{fields[2]}, *goal);
+  }
+  return results;
+}
+
+std::size_t CompareBenchResults(BenchResults const& results,
+                                BenchResults const& baseline,
+                                double threshold) {
+  std::size_t regression_count = 0;
+  std::cout << ae::Format("Comparison with baseline, threshold {:.1f}%:\n",
+                          threshold);
+  std::cout << ae::Format("{:<40} {:>12} {:>12} {:>9}\n", "metric",
+                          "baseline", "current", "change");
+  for (auto const& base_metric : baseline.metrics()) {
+    auto const* metric = results.Find(base_metric.name);
+    if (metric == nullptr) {
+      if (base_metric.goal != MetricGoal::kNone) {
+        ++regression_count;
+      }
+      std::cout << ae::Format("{:<40} {:>12.2f} {:>12} {:>9}\n",
+                              base_metric.name, base_metric.value, "missing",
+                              "");
+      continue;
+    }
+    auto worse = IsWorse(base_metric, metric->value, threshold);
+    if (worse) {
+      ++regression_count;
+    }
+    auto change = (base_metric.value != 0)
+                      ? (metric->value - base_metric.value) /
+                            std::abs(base_metric.value) * 100.0
+                      : 0.0;
+    std::cout << ae::Format("{:<40} {:>12.2f} {:>12.2f} {:>+8.1f}%{}\n",
+                            base_metric.name, base_metric.value, metric->value,
+                            change, worse ? " REGRESSION" : "");
+  }
+  std::cout << ae::Format("{} regressions\n", regression_count);
+  return regression_count;
+}
+
+int ReportBenchResults(BenchConfig const& config, BenchResults results) {
+  results.Add("process.cpu_time",
+              std::chrono::duration<double, std::milli>{ProcessCpuTime()}
+                  .count(),
+              "ms", MetricGoal::kLower);
+
+  if (!config.output_path.empty() &&
+      !WriteBenchResults(results, config.output_path)) {
+    std::cerr << ae::Format("Failed to write results to {}\n",
+                            config.output_path);
+    return 1;
+  }
+  if (config.baseline_path.empty()) {
+    return 0;
+  }
+  auto baseline = ReadBenchResults(config.baseline_path);
+  if (!baseline) {
+    std::cerr << ae::Format("Failed to read baseline from {}\n",
+                            config.baseline_path);
+    return 1;
+  }
+  if (CompareBenchResults(results, *baseline, config.regression_threshold) >
+      0) {
+    return 2;
+  }
+  return 0;
+}
@@ -0,0 +1,89 @@
+/*
+ * Copyright 2025 Aethernet Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef BENCH_BENCH_RESULTS_H_
+#define BENCH_BENCH_RESULTS_H_
+
+#include <string>
+#include <vector>
+#include <cstddef>
+#include <optional>
+#include <string_view>
+
+#include "bench/bench_config.h"
+#include "bench/latency_histogram.h"
+
+// which direction of change is an improvement
+enum class MetricGoal {
+  kNone,  // informational, never a regression
+  kLower,
+  kHigher,
+};
+
+struct Metric {
+  std::string name;
+  double value;
+  std::string unit;
+  MetricGoal goal;
+};
+
+/**
+ * \brief Flat list of named metrics of one benchmark run.
+ * Names are dot separated paths like "latency.inflight_1.p99".
+ */
+class BenchResults {
+ public:
+  void Add(std::string name, double value, std::string unit, MetricGoal goal);
+  /**
+   * \brief Add count, min, mean, percentiles, max and jitter in microseconds.
+   */
+  void AddLatency(std::string const& prefix,
+                  LatencyHistogram const& histogram);
+
+  Metric const* Find(std::string_view name) const;
+  std::vector<Metric> const& metrics() const { return metrics_; }
+
+ private:
+  std::vector<Metric> metrics_;
+};
+
+/**
+ * \brief Write results as JSON if path ends with .json, as CSV otherwise.
+ */
+bool WriteBenchResults(BenchResults const& results, std::string const& path);
+/**
+ * \brief Read results written as CSV.
+ * Returns std::nullopt if file can not be read or is malformed.
+ */
+std::optional<BenchResults> ReadBenchResults(std::string const& path);
+/**
+ * \brief Print the change of each baseline metric.
+ * Returns the number of metrics worse than the baseline by more than
+ * threshold percent, or missing from results.
+ */
+std::size_t CompareBenchResults(BenchResults const& results,
+                                BenchResults const& baseline,
+                                double threshold);
+
+/**
+ * \brief Add process CPU time, write results and compare them with the
+ * baseline as configured.
+ * Returns the process exit code: 0 on success, 1 on a file error and 2 on
+ * regression.
+ */
+int ReportBenchResults(BenchConfig const& config, BenchResults results);
+
+#endif  // BENCH_BENCH_RESULTS_H_
@@ -0,0 +1,53 @@
+/*
+ * Copyright 2025 Aethernet Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "bench/cpu_time.h"
+
+#if defined _WIN32
+#  include <windows.h>
+#else
+#  include <time.h>
+#endif
+
+#if defined _WIN32
+std::chrono::nanoseconds ProcessCpuTime() {
+  FILETIME creation_time;
+  FILETIME exit_time;
+  FILETIME kernel_time;
+  FILETIME user_time;
+  if (!GetProcessTimes(GetCurrentProcess(), &creation_time, &exit_time,
+                       &kernel_time, &user_time)) {
+    return {};
+  }
+  auto to_ticks = [](FILETIME const& time) {
+    return (static_cast<unsigned long long>(time.dwHighDateTime) << 32) |
+           time.dwLowDateTime;
+  };
+  // FILETIME is in 100 ns ticks
+  return std::chrono::nanoseconds{
+      static_cast<std::chrono::nanoseconds::rep>(
+          (to_ticks(kernel_time) + to_ticks(user_time)) * 100)};
+}
+#else
+std::chrono::nanoseconds ProcessCpuTime() {
+  timespec time{};
+  if (clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &time) != 0) {
+    return {};
+  }
+  return std::chrono::seconds{time.tv_sec} +
+         std::chrono::nanoseconds{time.tv_nsec};
+}
+#endif
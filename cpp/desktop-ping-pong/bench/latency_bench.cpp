@@ -0,0 +1,226 @@
+/*
+ * Copyright 2025 Aethernet Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "bench/latency_bench.h"
+
+#include <iostream>
+#include <algorithm>
+
+#include "alloc_counter.h"
+#include "async_logger.h"
+
+#include "bench/bench_report.h"
+
+namespace {
+// the answers have stopped if none comes for this time
+constexpr auto kAnswerTimeout = std::chrono::seconds{5};
+// the first answer also waits for the stream to be established
+constexpr auto kConnectTimeout = std::chrono::seconds{30};
+
+// keep the table much larger than the window, so a slot is reused only if its
+// ping is hopelessly late
+std::size_t PingTableCapacity(BenchConfig const& config) {
+  auto max_depth = *std::max_element(std::begin(config.inflight_depths),
+                                     std::end(config.inflight_depths));
+  return max_depth * 4;
+}
+}  // namespace
+
+LatencyBench::LatencyBench(ae::AetherApp& aether_app, BenchLink& link,
+                           BenchConfig const& config)
+    : aether_app_{&aether_app},
+      link_{&link},
+      config_{config},
+      ping_table_{PingTableCapacity(config_)} {
+  link_->set_receiver(
+      [this](ae::DataBuffer const& data) { PongReceived(data); });
+  std::cout << ae::Format("Latency benchmark: {} round trips, {} warmup\n",
+                          config_.message_count, config_.warmup_count);
+  StartStage();
+}
+
+void LatencyBench::StartStage() {
+  histogram_.Reset();
+  stage_sent_count_ = 0;
+  stage_received_count_ = 0;
+  ping_table_.ResetLost();
+  // the first round trips also include connection establishment
+  measure_start_time_ = ae::Now();
+  measure_end_time_ = measure_start_time_;
+  last_answer_time_ = measure_start_time_;
+  measure_start_allocations_ = AllocationCount();
+  measure_end_allocations_ = measure_start_allocations_;
+  measure_start_library_allocations_ = LibraryAllocationCount();
+  measure_end_library_allocations_ = measure_start_library_allocations_;
+  FillWindow();
+}
+
+void LatencyBench::FillWindow() {
+  auto depth = config_.inflight_depths[stage_index_];
+  auto total = config_.warmup_count + config_.message_count;
+  while ((ping_table_.in_flight_count() < depth) &&
+         (stage_sent_count_ < total)) {
+    SendPing();
+  }
+}
+
+void LatencyBench::SendPing() {
+  auto sequence = next_sequence_++;
+  ping_table_.Add(sequence, ae::Now());
+  ++stage_sent_count_;
+  link_->Write(MakePing(sequence));
+}
+
+void LatencyBench::PongReceived(ae::DataBuffer const& data_buffer) {
+  auto current_time = ae::Now();
+  auto sequence = ReadPingSequence(data_buffer);
+  if (!sequence) {
+    return;
+  }
+  // late answer for a ping already counted as lost is ignored
+  auto sent_time = ping_table_.Remove(*sequence);
+  if (!sent_time) {
+    return;
+  }
+  connected_ = true;
+  last_answer_time_ = current_time;
+
+  LogRoundTrip(*sequence, current_time - *sent_time);
+  // the time spent to log is a part of the message handling
+  current_time = ae::Now();
+
+  ++stage_received_count_;
+  if (stage_received_count_ == config_.warmup_count) {
+    measure_start_time_ = current_time;
+    measure_start_allocations_ = AllocationCount();
+    measure_start_library_allocations_ = LibraryAllocationCount();
+  }
+  if (stage_received_count_ > config_.warmup_count) {
+    histogram_.Record(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        current_time - *sent_time));
+    measure_end_time_ = current_time;
+    measure_end_allocations_ = AllocationCount();
+    measure_end_library_allocations_ = LibraryAllocationCount();
+  }
+
+  FillWindow();
+  if (ping_table_.in_flight_count() == 0) {
+    FinishStage();
+  }
+}
+
+ae::TimePoint LatencyBench::Update(ae::TimePoint current_time) {
+  auto deadline =
+      last_answer_time_ + (connected_ ? kAnswerTimeout : kConnectTimeout);
+  if (finished_ || (ping_table_.in_flight_count() == 0)) {
+    return current_time + kAnswerTimeout;
+  }
+  if (current_time < deadline) {
+    return deadline;
+  }
+  // count the unanswered pings as lost and go on
+  ping_table_.Expire();
+  last_answer_time_ = current_time;
+  auto total = config_.warmup_count + config_.message_count;
+  if (!connected_) {
+    std::cerr << "Latency benchmark: the stream is not established\n";
+    finished_ = true;
+    aether_app_->Exit(1);
+  } else if (stage_sent_count_ < total) {
+    FillWindow();
+  } else {
+    FinishStage();
+  }
+  return current_time;
+}
+
+void LatencyBench::LogRoundTrip(std::uint32_t sequence,
+                                ae::TimePoint::duration round_trip) const {
+  auto micros = std::chrono::duration<double, std::micro>{round_trip}.count();
+  switch (config_.log_mode) {
+    case LogMode::kNone:
+      break;
+    case LogMode::kSync:
+      std::cout << ae::Format("Pong {} in {:.1f} us\n", sequence, micros);
+      break;
+    case LogMode::kAsync:
+      Logger().Log([sequence, micros]() {
+        return ae::Format("Pong {} in {:.1f} us\n", sequence, micros);
+      });
+      break;
+  }
+}
+
+void LatencyBench::FinishStage() {
+  auto elapsed = std::chrono::duration_cast<std::chrono::duration<double>>(
+      measure_end_time_ - measure_start_time_);
+  auto rate = (elapsed.count() > 0)
+                  ? static_cast<double>(histogram_.count()) / elapsed.count()
+                  : 0.0;
+  auto allocations = static_cast<double>(measure_end_allocations_ -
+                                         measure_start_allocations_);
+  auto library_allocations =
+      static_cast<double>(measure_end_library_allocations_ -
+                          measure_start_library_allocations_);
+  auto round_trips = static_cast<double>(histogram_.count());
+  results_.push_back(StageResult{
+      config_.inflight_depths[stage_index_],
+      rate,
+      elapsed.count(),
+      ping_table_.lost_count(),
+      (round_trips > 0) ? allocations / round_trips : 0.0,
+      (round_trips > 0) ? library_allocations / round_trips : 0.0,
+      histogram_,
+  });
+  PrintReport(results_.back());
+
+  if (++stage_index_ < config_.inflight_depths.size()) {
+    StartStage();
+    return;
+  }
+  finished_ = true;
+  aether_app_->Exit(0);
+}
+
+void LatencyBench::CollectResults(BenchResults& results) const {
+  for (auto const& result : results_) {
+    auto prefix = ae::Format("latency.inflight_{}", result.depth);
+    results.Add(prefix + ".rate", result.rate, "msg/s", MetricGoal::kHigher);
+    results.Add(prefix + ".lost", static_cast<double>(result.lost_count), "",
+                MetricGoal::kLower);
+    results.Add(prefix + ".allocations", result.allocations_per_round_trip,
+                "per round trip", MetricGoal::kLower);
+    results.Add(prefix + ".library_allocations",
+                result.library_allocations_per_round_trip, "per round trip",
+                MetricGoal::kLower);
+    results.AddLatency(prefix, result.histogram);
+  }
+}
+
+void LatencyBench::PrintReport(StageResult const& result) {
+  std::cout << ae::Format(
+      "In-flight {}: {} round trips in {:.3f} s ({:.1f} msg/s), {} lost\n",
+      result.depth, result.histogram.count(), result.elapsed, result.rate,
+      result.lost_count);
+  PrintLatencyReport(result.histogram);
+  std::cout << ae::Format(
+      "  process heap allocations {:.2f} per round trip, {:.2f} by the "
+      "application and {:.2f} by the client library\n",
+      result.allocations_per_round_trip,
+      result.allocations_per_round_trip -
+          result.library_allocations_per_round_trip,
+      result.library_allocations_per_round_trip);
+}
@@ -0,0 +1,101 @@
+/*
+ * Copyright 2025 Aethernet Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef BENCH_LATENCY_BENCH_H_
+#define BENCH_LATENCY_BENCH_H_
+
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+#include "aether/all.h"
+
+#include "bench/bench_link.h"
+#include "bench/bench_config.h"
+#include "bench/bench_results.h"
+#include "bench/ping_table.h"
+#include "bench/latency_histogram.h"
+
+/**
+ * \brief Alice's side of the latency benchmark.
+ * Each ping carries a sequence number which Bob echoes back, so several pings
+ * may be in flight at once. The benchmark runs a stage per configured
+ * in-flight depth: keeps the window full until the configured number of round
+ * trips is received, drains it, prints the stage report and moves to the next
+ * depth. After the last stage exits the application.
+ * If no answer comes for a timeout, the pings in flight are counted as lost,
+ * so a lost ping does not stall the stage.
+ * With a log mode each round trip is printed in the answer handler before the
+ * round trip is recorded, to show the cost of console output on the hot path.
+ */
+class LatencyBench {
+ public:
+  LatencyBench(ae::AetherApp& aether_app, BenchLink& link,
+               BenchConfig const& config);
+
+  /**
+   * \brief Expire the pings in flight if the answers have stopped.
+   * Returns the time it should be called next.
+   */
+  ae::TimePoint Update(ae::TimePoint current_time);
+
+  void CollectResults(BenchResults& results) const;
+
+ private:
+  struct StageResult {
+    std::size_t depth;
+    double rate;
+    double elapsed;
+    std::size_t lost_count;
+    double allocations_per_round_trip;
+    double library_allocations_per_round_trip;
+    LatencyHistogram histogram;
+  };
+
+  void StartStage();
+  void FillWindow();
+  void SendPing();
+  void PongReceived(ae::DataBuffer const& data_buffer);
+  void LogRoundTrip(std::uint32_t sequence,
+                    ae::TimePoint::duration round_trip) const;
+  void FinishStage();
+  static void PrintReport(StageResult const& result);
+
+  ae::AetherApp* aether_app_;
+  BenchLink* link_;
+  BenchConfig config_;
+
+  PingTable ping_table_;
+  std::uint32_t next_sequence_{};
+  bool connected_{};
+  bool finished_{};
+  // the last answer or the stage start
+  ae::TimePoint last_answer_time_;
+
+  std::size_t stage_index_{};
+  std::size_t stage_sent_count_{};
+  std::size_t stage_received_count_{};
+  LatencyHistogram histogram_;
+  ae::TimePoint measure_start_time_;
+  ae::TimePoint measure_end_time_;
+  std::uint64_t measure_start_allocations_{};
+  std::uint64_t measure_end_allocations_{};
+  std::uint64_t measure_start_library_allocations_{};
+  std::uint64_t measure_end_library_allocations_{};
+  std::vector<StageResult> results_;
+};
+
+#endif  // BENCH_LATENCY_BENCH_H_
@@ -0,0 +1,125 @@
+/*
+ * Copyright 2025 Aethernet Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "bench/latency_histogram.h"
+
+#include <bit>
+#include <cmath>
+#include <algorithm>
+
+LatencyHistogram::LatencyHistogram() : counts_(kBucketCount) {}
+
+void LatencyHistogram::Record(std::chrono::nanoseconds latency) {
+  auto value = static_cast<std::uint64_t>(
+      std::max(latency.count(), std::chrono::nanoseconds::rep{0}));
+
+  counts_[BucketIndex(value)]++;
+  if ((count_ == 0) || (value < min_)) {
+    min_ = value;
+  }
+  max_ = std::max(max_, value);
+  sum_ += value;
+  if (count_ != 0) {
+    jitter_sum_ += (value > last_) ? (value - last_) : (last_ - value);
+    jitter_count_++;
+  }
+  last_ = value;
+  count_++;
+}
+
+void LatencyHistogram::Merge(LatencyHistogram const& other) {
+  if (other.count_ == 0) {
+    return;
+  }
+  for (std::size_t i = 0; i < kBucketCount; ++i) {
+    counts_[i] += other.counts_[i];
+  }
+  min_ = (count_ == 0) ? other.min_ : std::min(min_, other.min_);
+  max_ = std::max(max_, other.max_);
+  sum_ += other.sum_;
+  jitter_sum_ += other.jitter_sum_;
+  jitter_count_ += other.jitter_count_;
+  count_ += other.count_;
+}
+
+void LatencyHistogram::Reset() {
+  std::fill(std::begin(counts_), std::end(counts_), std::uint64_t{0});
+  count_ = min_ = max_ = sum_ = last_ = jitter_sum_ = jitter_count_ = 0;
+}
+
+std::chrono::nanoseconds LatencyHistogram::min() const {
+  return std::chrono::nanoseconds{min_};
+}
+
+std::chrono::nanoseconds LatencyHistogram::max() const {
+  return std::chrono::nanoseconds{max_};
+}
+
+std::chrono::nanoseconds LatencyHistogram::mean() const {
+  if (count_ == 0) {
+    return {};
+  }
+  return std::chrono::nanoseconds{sum_ / count_};
+}
+
+std::chrono::nanoseconds LatencyHistogram::jitter() const {
+  if (jitter_count_ == 0) {
+    return {};
+  }
+  return std::chrono::nanoseconds{jitter_sum_ / jitter_count_};
+}
+
+std::chrono::nanoseconds LatencyHistogram::Percentile(double percentile) const {
+  if (count_ == 0) {
+    return {};
+  }
+  percentile = std::clamp(percentile, 0.0, 100.0);
+  auto rank = static_cast<std::uint64_t>(
+      std::ceil(percentile / 100.0 * static_cast<double>(count_)));
+  rank = std::max(rank, std::uint64_t{1});
+
+  std::uint64_t accumulated = 0;
+  for (std::size_t i = 0; i < kBucketCount; ++i) {
+    accumulated += counts_[i];
+    if (accumulated >= rank) {
+      return std::chrono::nanoseconds{std::min(BucketHighestValue(i), max_)};
+    }
+  }
+  return std::chrono::nanoseconds{max_};
+}
+
+std::size_t LatencyHistogram::BucketIndex(std::uint64_t value) {
+  value = std::min(value, (std::uint64_t{1} << kMaxValueBits) - 1);
+  if (value < kSubBucketCount) {
+    return static_cast<std::size_t>(value);
+  }
+  // shift value so it fits into the upper half of sub buckets
+  auto shift = static_cast<std::size_t>(std::bit_width(value)) - kSubBucketBits;
+  auto sub_bucket = static_cast<std::size_t>(value >> shift);
+  return kSubBucketCount + (shift - 1) * kSubBucketHalf +
+         (sub_bucket - kSubBucketHalf);
+}
+
+std::uint64_t LatencyHistogram::BucketHighestValue(std::size_t index) {
+  if (index < kSubBucketCount) {
+    return index;
+  }
+  auto relative = index - kSubBucketCount;
+  auto shift = relative / kSubBucketHalf + 1;
+  auto sub_bucket =
+      static_cast<std::uint64_t>(relative % kSubBucketHalf + kSubBucketHalf);
+  return (sub_bucket << shift) + ((std::uint64_t{1} << shift) - 1);
+}
@@ -0,0 +1,78 @@
+/*
+ * Copyright 2025 Aethernet Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef BENCH_LATENCY_HISTOGRAM_H_
+#define BENCH_LATENCY_HISTOGRAM_H_
+
+#include <chrono>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * \brief HDR-style latency histogram.
+ * Values are stored in nanoseconds in log-bucketed counters: each power of two
+ * range is split into kSubBucketHalf linear sub buckets, so the relative error
+ * of any reported value is below 1 / kSubBucketHalf (~1.6%) while the memory
+ * footprint stays fixed regardless of the number of recorded samples.
+ */
+class LatencyHistogram {
+ public:
+  static constexpr std::size_t kSubBucketBits = 7;
+  static constexpr std::size_t kSubBucketCount = std::size_t{1}
+                                                 << kSubBucketBits;
+  static constexpr std::size_t kSubBucketHalf = kSubBucketCount / 2;
+  // values above 2^40 ns (~18 min) are clamped to the highest bucket
+  static constexpr std::size_t kMaxValueBits = 40;
+  static constexpr std::size_t kBucketCount =
+      kSubBucketCount + (kMaxValueBits - kSubBucketBits) * kSubBucketHalf;
+
+  LatencyHistogram();
+
+  void Record(std::chrono::nanoseconds latency);
+  void Merge(LatencyHistogram const& other);
+  void Reset();
+
+  std::uint64_t count() const { return count_; }
+  std::chrono::nanoseconds min() const;
+  std::chrono::nanoseconds max() const;
+  std::chrono::nanoseconds mean() const;
+  /**
+   * \brief Mean absolute difference between consecutive samples.
+   */
+  std::chrono::nanoseconds jitter() const;
+  /**
+   * \brief Value at percentile in range [0, 100].
+   * Reports the highest value equivalent to the bucket the percentile falls
+   * into, but never more than the exact recorded maximum.
+   */
+  std::chrono::nanoseconds Percentile(double percentile) const;
+
+ private:
+  static std::size_t BucketIndex(std::uint64_t value);
+  static std::uint64_t BucketHighestValue(std::size_t index);
+
+  std::vector<std::uint64_t> counts_;
+  std::uint64_t count_{};
+  std::uint64_t min_{};
+  std::uint64_t max_{};
+  std::uint64_t sum_{};
+  std::uint64_t last_{};
+  std::uint64_t jitter_sum_{};
+  std::uint64_t jitter_count_{};
+};
+
+#endif  // BENCH_LATENCY_HISTOGRAM_H_
@@ -0,0 +1,373 @@
+/*
+ * Copyright 2025 Aethernet Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "bench/pairs_bench.h"
+
+#include <string>
+#include <iostream>
+#include <algorithm>
+
+#include "bench/ping_table.h"
+#include "bench/bench_report.h"
+
+namespace {
+// time to wait for the answers after the stage duration is over
+constexpr auto kDrainTimeout = std::chrono::seconds{5};
+// a ping not answered for this time while measuring is lost
+constexpr auto kAnswerTimeout = std::chrono::seconds{5};
+// time for every pair to establish its stream and complete the first round trip
+constexpr auto kConnectTimeout = std::chrono::seconds{30};
+
+std::chrono::nanoseconds Elapsed(ae::TimePoint from, ae::TimePoint to) {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(to - from);
+}
+
+ae::TimePoint::duration Seconds(double seconds) {
+  return std::chrono::duration_cast<ae::TimePoint::duration>(
+      std::chrono::duration<double>{seconds});
+}
+}  // namespace
+
+struct PairsBench::Pair {
+  ae::Client::ptr alice;
+  ae::Client::ptr bob;
+  std::unique_ptr<ae::P2pStream> alice_stream;
+  std::unique_ptr<ae::P2pStream> bob_stream;
+  ae::Subscription alice_receive_sub;
+  ae::Subscription bob_new_stream_sub;
+  ae::Subscription bob_receive_sub;
+
+  ae::TimePoint ping_sent_time;
+  std::uint32_t ping_sequence{};
+  bool connected{};
+  LatencyHistogram histogram;
+};
+
+void MergePairsStageResult(PairsStageResult& to, PairsStageResult const& from) {
+  to.pair_count += from.pair_count;
+  to.round_trip_count += from.round_trip_count;
+  to.round_trip_rate += from.round_trip_rate;
+  to.lost_count += from.lost_count;
+  to.round_trips.Merge(from.round_trips);
+  to.pair_p50.insert(std::end(to.pair_p50), std::begin(from.pair_p50),
+                     std::end(from.pair_p50));
+  to.pair_p99.insert(std::end(to.pair_p99), std::begin(from.pair_p99),
+                     std::end(from.pair_p99));
+  std::sort(std::begin(to.pair_p50), std::end(to.pair_p50));
+  std::sort(std::begin(to.pair_p99), std::end(to.pair_p99));
+  to.create_stream.Merge(from.create_stream);
+  to.app_update.Merge(from.app_update);
+}
+
+void PrintPairsStageResult(PairsStageResult const& result) {
+  std::cout << ae::Format(
+      "Pairs {}: {} round trips ({:.1f} round trips/s), {} lost\n",
+      result.pair_count, result.round_trip_count, result.round_trip_rate,
+      result.lost_count);
+  PrintLatencyReport(result.round_trips);
+  if (!result.pair_p50.empty()) {
+    auto const& p50 = result.pair_p50;
+    auto const& p99 = result.pair_p99;
+    std::cout << ae::Format(
+        "  per pair p50 min/median/max {:.1f}/{:.1f}/{:.1f} us\n",
+        ToMicros(p50.front()), ToMicros(p50[p50.size() / 2]),
+        ToMicros(p50.back()));
+    std::cout << ae::Format(
+        "  per pair p99 min/median/max {:.1f}/{:.1f}/{:.1f} us\n",
+        ToMicros(p99.front()), ToMicros(p99[p99.size() / 2]),
+        ToMicros(p99.back()));
+  }
+  std::cout << ae::Format(
+      "  CreatePort + P2pStream: {} streams, mean {:.1f} us, p99 {:.1f} us\n",
+      result.create_stream.count(), ToMicros(result.create_stream.mean()),
+      ToMicros(result.create_stream.Percentile(99.0)));
+  std::cout << ae::Format(
+      "  AetherApp::Update: {} calls, mean {:.1f} us, p99 {:.1f} us, max "
+      "{:.1f} us\n",
+      result.app_update.count(), ToMicros(result.app_update.mean()),
+      ToMicros(result.app_update.Percentile(99.0)),
+      ToMicros(result.app_update.max()));
+}
+
+void AddPairsStageResult(BenchResults& results,
+                         PairsStageResult const& result) {
+  auto prefix = ae::Format("pairs.{}", result.pair_count);
+  results.Add(prefix + ".round_trip_rate", result.round_trip_rate,
+              "round trips/s", MetricGoal::kHigher);
+  results.Add(prefix + ".lost", static_cast<double>(result.lost_count), "",
+              MetricGoal::kLower);
+  results.AddLatency(prefix, result.round_trips);
+  results.Add(prefix + ".create_stream.mean",
+              ToMicros(result.create_stream.mean()), "us", MetricGoal::kLower);
+  results.Add(prefix + ".app_update.mean", ToMicros(result.app_update.mean()),
+              "us", MetricGoal::kLower);
+  // a single slow update of the loop is noise, only its mean is gated
+  results.Add(prefix + ".app_update.p99",
+              ToMicros(result.app_update.Percentile(99.0)), "us",
+              MetricGoal::kNone);
+}
+
+PairsBench::PairsBench(ae::AetherApp& aether_app, ae::Uid parent_uid,
+                       BenchConfig const& config, PairsBenchOptions options)
+    : aether_app_{&aether_app},
+      config_{config},
+      options_{std::move(options)} {
+  auto max_pairs = *std::max_element(std::begin(config_.pair_counts),
+                                     std::end(config_.pair_counts));
+  if (options_.print_stages) {
+    std::cout << ae::Format("Pairs benchmark: select {} clients\n",
+                            max_pairs * 2);
+  }
+
+  pairs_.reserve(max_pairs);
+  for (std::size_t i = 0; i < max_pairs; ++i) {
+    auto* pair = pairs_.emplace_back(std::make_unique<Pair>()).get();
+    auto index = std::to_string(i);
+
+    aether_app_->aether()
+        ->SelectClient(parent_uid, options_.client_prefix + "Alice" + index)
+        .result_event()
+        .Subscribe([this, pair](auto const& res) {
+          if (!res) {
+            aether_app_->Exit(1);
+            return;
+          }
+          pair->alice = res.value();
+          ClientSelected();
+        });
+
+    aether_app_->aether()
+        ->SelectClient(parent_uid, options_.client_prefix + "Bob" + index)
+        .result_event()
+        .Subscribe([this, pair](auto const& res) {
+          if (!res) {
+            aether_app_->Exit(1);
+            return;
+          }
+          pair->bob = res.value();
+          // Bob answers each ping with its header
+          pair->bob_new_stream_sub =
+              pair->bob->message_stream_manager().new_port_event().Subscribe(
+                  [this, pair](ae::P2pPortHandle p2p_port) {
+                    pair->bob_stream = std::make_unique<ae::P2pStream>(
+                        *aether_app_, pair->bob.Load(), p2p_port.destination(),
+                        std::move(p2p_port));
+                    pair->bob_receive_sub =
+                        pair->bob_stream->out_data_event().Subscribe(
+                            [pair](ae::DataBuffer const& data) {
+                              auto header_size = std::min(
+                                  data.size(), sizeof(std::uint32_t));
+                              pair->bob_stream->Write(
+                                  {std::begin(data),
+                                   std::begin(data) + header_size});
+                            });
+                  });
+          ClientSelected();
+        });
+  }
+}
+
+PairsBench::~PairsBench() = default;
+
+ae::TimePoint PairsBench::Update(ae::TimePoint current_time) {
+  switch (state_) {
+    case State::kSelectClients:
+      break;
+    case State::kConnecting:
+      if (current_time < connect_deadline_) {
+        return connect_deadline_;
+      }
+      // a pair that never connects would hold the stage and, with several
+      // threads, all the others waiting for the next stage
+      std::cerr << ae::Format(
+          "Pairs benchmark: {} of {} pairs are not connected in {} s\n",
+          stage_pair_count_ - connected_count_, stage_pair_count_,
+          std::chrono::duration_cast<std::chrono::seconds>(kConnectTimeout)
+              .count());
+      state_ = State::kSelectClients;
+      aether_app_->Exit(1);
+      return current_time;
+    case State::kMeasuring:
+      if (current_time < measure_end_time_) {
+        return std::min(measure_end_time_, ExpirePings(current_time));
+      }
+      // stop sending, each pair has exactly one ping in flight
+      state_ = State::kDraining;
+      in_flight_count_ = stage_pair_count_;
+      drain_deadline_ = current_time + kDrainTimeout;
+      [[fallthrough]];
+    case State::kDraining:
+      if ((in_flight_count_ == 0) || (current_time >= drain_deadline_)) {
+        FinishStage();
+        return current_time;
+      }
+      return drain_deadline_;
+  }
+  return current_time + std::chrono::seconds{1};
+}
+
+void PairsBench::OnAppUpdate(std::chrono::nanoseconds update_duration) {
+  if (state_ == State::kMeasuring) {
+    app_update_histogram_.Record(update_duration);
+  }
+}
+
+void PairsBench::ClientSelected() {
+  if (++selected_count_ < pairs_.size() * 2) {
+    return;
+  }
+  if (options_.save_state) {
+    // Save the current aether state
+    auto lock = options_.storage_mutex != nullptr
+                    ? std::unique_lock{*options_.storage_mutex}
+                    : std::unique_lock<std::mutex>{};
+    aether_app_->aether().Save();
+  }
+  StartStage();
+}
+
+void PairsBench::StartStage() {
+  if (options_.stage_sync) {
+    options_.stage_sync();
+  }
+  stage_pair_count_ = config_.pair_counts[stage_index_];
+  connected_count_ = 0;
+  round_trip_count_ = 0;
+  lost_count_ = 0;
+  create_stream_histogram_.Reset();
+  app_update_histogram_.Reset();
+  state_ = State::kConnecting;
+  connect_deadline_ = ae::Now() + kConnectTimeout;
+
+  for (std::size_t i = 0; i < stage_pair_count_; ++i) {
+    auto* pair = pairs_[i].get();
+    pair->connected = false;
+    pair->histogram.Reset();
+
+    auto bobs_uid = pair->bob->uid();
+    auto start_time = ae::Now();
+    pair->alice_stream = std::make_unique<ae::P2pStream>(
+        *aether_app_, pair->alice.Load(), bobs_uid,
+        pair->alice->message_stream_manager().CreatePort(bobs_uid));
+    create_stream_histogram_.Record(Elapsed(start_time, ae::Now()));
+
+    pair->alice_receive_sub = pair->alice_stream->out_data_event().Subscribe(
+        [this, pair](ae::DataBuffer const& data) {
+          PongReceived(*pair, data);
+        });
+    SendPing(*pair);
+  }
+}
+
+void PairsBench::FinishStage() {
+  results_.push_back(StageResult());
+  if (options_.print_stages) {
+    PrintPairsStageResult(results_.back());
+  }
+
+  // close all the streams before the next stage
+  for (auto& pair : pairs_) {
+    pair->alice_receive_sub = ae::Subscription{};
+    pair->bob_receive_sub = ae::Subscription{};
+    pair->alice_stream.reset();
+    pair->bob_stream.reset();
+  }
+
+  if (++stage_index_ < config_.pair_counts.size()) {
+    StartStage();
+    return;
+  }
+  aether_app_->Exit(0);
+}
+
+void PairsBench::SendPing(Pair& pair) {
+  pair.ping_sent_time = ae::Now();
+  pair.ping_sequence = next_sequence_++;
+  pair.alice_stream->Write(MakePing(pair.ping_sequence));
+}
+
+void PairsBench::PongReceived(Pair& pair, ae::DataBuffer const& data) {
+  auto sequence = ReadPingSequence(data);
+  if (!sequence || (*sequence != pair.ping_sequence)) {
+    // late answer for a ping already counted as lost
+    return;
+  }
+  auto current_time = ae::Now();
+  switch (state_) {
+    case State::kSelectClients:
+      break;
+    case State::kConnecting:
+      if (!pair.connected) {
+        pair.connected = true;
+        if (++connected_count_ == stage_pair_count_) {
+          state_ = State::kMeasuring;
+          measure_start_time_ = current_time;
+          measure_end_time_ = current_time + Seconds(config_.stage_duration);
+        }
+      }
+      SendPing(pair);
+      break;
+    case State::kMeasuring:
+      pair.histogram.Record(Elapsed(pair.ping_sent_time, current_time));
+      ++round_trip_count_;
+      SendPing(pair);
+      break;
+    case State::kDraining:
+      --in_flight_count_;
+      break;
+  }
+}
+
+ae::TimePoint PairsBench::ExpirePings(ae::TimePoint current_time) {
+  auto next_time = current_time + kAnswerTimeout;
+  for (std::size_t i = 0; i < stage_pair_count_; ++i) {
+    auto& pair = *pairs_[i];
+    auto deadline = pair.ping_sent_time + kAnswerTimeout;
+    if (deadline <= current_time) {
+      ++lost_count_;
+      SendPing(pair);
+      deadline = pair.ping_sent_time + kAnswerTimeout;
+    }
+    next_time = std::min(next_time, deadline);
+  }
+  return next_time;
+}
+
+PairsStageResult PairsBench::StageResult() const {
+  auto elapsed = std::chrono::duration_cast<std::chrono::duration<double>>(
+      measure_end_time_ - measure_start_time_);
+
+  auto result = PairsStageResult{
+      stage_pair_count_,
+      round_trip_count_,
+      static_cast<double>(round_trip_count_) / elapsed.count(),
+      lost_count_,
+      {},
+      {},
+      {},
+      create_stream_histogram_,
+      app_update_histogram_,
+  };
+  for (std::size_t i = 0; i < stage_pair_count_; ++i) {
+    auto const& histogram = pairs_[i]->histogram;
+    result.round_trips.Merge(histogram);
+    result.pair_p50.push_back(histogram.Percentile(50.0));
+    result.pair_p99.push_back(histogram.Percentile(99.0));
+  }
+  std::sort(std::begin(result.pair_p50), std::end(result.pair_p50));
+  std::sort(std::begin(result.pair_p99), std::end(result.pair_p99));
+  return result;
+}
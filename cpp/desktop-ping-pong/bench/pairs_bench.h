@@ -0,0 +1,146 @@
+/*
+ * Copyright 2025 Aethernet Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef BENCH_PAIRS_BENCH_H_
+#define BENCH_PAIRS_BENCH_H_
+
+#include <chrono>
+#include <mutex>
+#include <memory>
+#include <string>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+
+#include "aether/all.h"
+
+#include "bench/bench_config.h"
+#include "bench/bench_results.h"
+#include "bench/latency_histogram.h"
+
+struct PairsStageResult {
+  std::size_t pair_count;
+  std::uint64_t round_trip_count;
+  double round_trip_rate;
+  // pings not answered within the answer timeout
+  std::uint64_t lost_count;
+  LatencyHistogram round_trips;
+  std::vector<std::chrono::nanoseconds> pair_p50;
+  std::vector<std::chrono::nanoseconds> pair_p99;
+  LatencyHistogram create_stream;
+  LatencyHistogram app_update;
+};
+
+/**
+ * \brief Combine results of the same stage run by several applications.
+ */
+void MergePairsStageResult(PairsStageResult& to, PairsStageResult const& from);
+void PrintPairsStageResult(PairsStageResult const& result);
+void AddPairsStageResult(BenchResults& results,
+                         PairsStageResult const& result);
+
+struct PairsBenchOptions {
+  // prefix for client names, to give each application its own clients
+  std::string client_prefix;
+  // called before each stage, used to start stages of several apps together
+  std::function<void()> stage_sync;
+  // print each stage report as soon as it finishes
+  bool print_stages = true;
+  // save the aether state once the clients are selected
+  bool save_state = true;
+  // guards the state storage if it is shared with other applications
+  std::mutex* storage_mutex = nullptr;
+};
+
+/**
+ * \brief Many Alice/Bob client pairs in one AetherApp.
+ * Selects (registers or loads) the clients for the largest configured pair
+ * count, then runs a stage per count: creates a P2pStream for each active pair,
+ * waits for every pair to complete its first round trip, and runs closed-loop
+ * ping-pong on all of them at once for the stage duration. Reports aggregate
+ * round trips per second, latency distribution over all and per pair, and the
+ * cost of stream creation and AetherApp::Update as the stream count grows.
+ * If a pair does not connect within a timeout, the application exits with an
+ * error. A ping not answered within a timeout while measuring is counted as
+ * lost and the pair sends the next one.
+ */
+class PairsBench {
+ public:
+  PairsBench(ae::AetherApp& aether_app, ae::Uid parent_uid,
+             BenchConfig const& config, PairsBenchOptions options = {});
+  ~PairsBench();
+
+  /**
+   * \brief Drive the stage timing.
+   * Must be called on each application loop iteration.
+   * Returns the time it should be called next.
+   */
+  ae::TimePoint Update(ae::TimePoint current_time);
+  /**
+   * \brief Report the time spent in the AetherApp::Update call.
+   */
+  void OnAppUpdate(std::chrono::nanoseconds update_duration);
+
+  std::vector<PairsStageResult> const& results() const { return results_; }
+
+ private:
+  struct Pair;
+
+  enum class State {
+    kSelectClients,
+    kConnecting,  // wait for the first round trip on every pair
+    kMeasuring,
+    kDraining,  // wait for the answers to the last pings
+  };
+
+  void ClientSelected();
+  void StartStage();
+  void FinishStage();
+  void SendPing(Pair& pair);
+  void PongReceived(Pair& pair, ae::DataBuffer const& data);
+  /**
+   * \brief Count the pings unanswered for the answer timeout as lost and send
+   * the next ones. Returns the time the next ping times out.
+   */
+  ae::TimePoint ExpirePings(ae::TimePoint current_time);
+  PairsStageResult StageResult() const;
+
+  ae::AetherApp* aether_app_;
+  BenchConfig config_;
+  PairsBenchOptions options_;
+
+  State state_{State::kSelectClients};
+  std::vector<std::unique_ptr<Pair>> pairs_;
+  std::size_t selected_count_{};
+
+  std::size_t stage_index_{};
+  std::size_t stage_pair_count_{};
+  std::size_t connected_count_{};
+  std::size_t in_flight_count_{};
+  std::uint64_t round_trip_count_{};
+  std::uint64_t lost_count_{};
+  std::uint32_t next_sequence_{};
+  ae::TimePoint connect_deadline_;
+  ae::TimePoint measure_start_time_;
+  ae::TimePoint measure_end_time_;
+  ae::TimePoint drain_deadline_;
+  LatencyHistogram create_stream_histogram_;
+  LatencyHistogram app_update_histogram_;
+  std::vector<PairsStageResult> results_;
+};
+
+#endif  // BENCH_PAIRS_BENCH_H_
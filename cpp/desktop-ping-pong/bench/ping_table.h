@@ -0,0 +1,115 @@
+/*
+ * Copyright 2025 Aethernet Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef BENCH_PING_TABLE_H_
+#define BENCH_PING_TABLE_H_
+
+#include <bit>
+#include <vector>
+#include <cstring>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <algorithm>
+
+#include "aether/all.h"
+
+/**
+ * \brief Send times of in-flight pings indexed by sequence number.
+ * Fixed size ring, a slot is selected by sequence & mask. If a slot is still
+ * occupied when its sequence comes around again, the older ping is counted as
+ * lost.
+ */
+class PingTable {
+ public:
+  explicit PingTable(std::size_t min_capacity)
+      : slots_(std::bit_ceil(std::max(min_capacity, std::size_t{1}))),
+        mask_{static_cast<std::uint32_t>(slots_.size() - 1)} {}
+
+  void Add(std::uint32_t sequence, ae::TimePoint time) {
+    auto& slot = slots_[sequence & mask_];
+    if (slot.in_flight) {
+      ++lost_count_;
+      --in_flight_count_;
+    }
+    slot = Slot{sequence, time, true};
+    ++in_flight_count_;
+  }
+
+  /**
+   * \brief Remove the ping and return its time.
+   * Returns std::nullopt for unknown or already lost sequence.
+   */
+  std::optional<ae::TimePoint> Remove(std::uint32_t sequence) {
+    auto& slot = slots_[sequence & mask_];
+    if (!slot.in_flight || (slot.sequence != sequence)) {
+      return std::nullopt;
+    }
+    slot.in_flight = false;
+    --in_flight_count_;
+    return slot.time;
+  }
+
+  /**
+   * \brief Count all in-flight pings as lost.
+   */
+  void Expire() {
+    for (auto& slot : slots_) {
+      slot.in_flight = false;
+    }
+    lost_count_ += in_flight_count_;
+    in_flight_count_ = 0;
+  }
+
+  void ResetLost() { lost_count_ = 0; }
+
+  std::size_t in_flight_count() const { return in_flight_count_; }
+  std::size_t lost_count() const { return lost_count_; }
+
+ private:
+  struct Slot {
+    std::uint32_t sequence;
+    ae::TimePoint time;
+    bool in_flight;
+  };
+
+  std::vector<Slot> slots_;
+  std::uint32_t mask_;
+  std::size_t in_flight_count_{};
+  std::size_t lost_count_{};
+};
+
+/**
+ * \brief Ping message is a sequence number followed by optional padding.
+ */
+inline ae::DataBuffer MakePing(std::uint32_t sequence,
+                               std::size_t size = sizeof(std::uint32_t)) {
+  ae::DataBuffer message(std::max(size, sizeof(sequence)));
+  std::memcpy(message.data(), &sequence, sizeof(sequence));
+  return message;
+}
+
+inline std::optional<std::uint32_t> ReadPingSequence(
+    ae::DataBuffer const& message) {
+  std::uint32_t sequence{};
+  if (message.size() < sizeof(sequence)) {
+    return std::nullopt;
+  }
+  std::memcpy(&sequence, message.data(), sizeof(sequence));
+  return sequence;
+}
+
+#endif  // BENCH_PING_TABLE_H_
@@ -0,0 +1,228 @@
+/*
+ * Copyright 2025 Aethernet Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "bench/rate_bench.h"
+
+#include <cmath>
+#include <iostream>
+#include <algorithm>
+
+#include "alloc_counter.h"
+
+#include "bench/bench_report.h"
+
+namespace {
+// time to wait for the answers after the last ping of the stage is sent
+constexpr auto kDrainTimeout = std::chrono::seconds{5};
+// time for the stream to be established and answer a probe
+constexpr auto kConnectTimeout = std::chrono::seconds{30};
+// a probe may be lost, send the next one after this time
+constexpr auto kProbeInterval = std::chrono::seconds{1};
+
+// a slot for each ping of the longest stage and its drain time, so a slow
+// answer is recorded with its whole latency instead of being overwritten
+std::size_t PingTableCapacity(BenchConfig const& config) {
+  auto max_rate =
+      *std::max_element(std::begin(config.rates), std::end(config.rates));
+  auto drain_time = std::chrono::duration<double>{kDrainTimeout}.count();
+  return static_cast<std::size_t>(
+             std::ceil(max_rate * (config.stage_duration + drain_time))) +
+         config.warmup_count;
+}
+}  // namespace
+
+RateBench::RateBench(ae::AetherApp& aether_app, BenchLink& link,
+                     BenchConfig const& config)
+    : aether_app_{&aether_app},
+      link_{&link},
+      config_{config},
+      ping_table_{PingTableCapacity(config_)} {
+  link_->set_receiver(
+      [this](ae::DataBuffer const& data) { PongReceived(data); });
+  std::cout << ae::Format(
+      "Open-loop benchmark: {} stages of {:.1f} s, {} warmup pings each\n",
+      config_.rates.size(), config_.stage_duration, config_.warmup_count);
+  // the schedule starts only after the stream is established
+  auto current_time = ae::Now();
+  connect_deadline_ = current_time + kConnectTimeout;
+  SendProbe(current_time);
+}
+
+ae::TimePoint RateBench::Update(ae::TimePoint current_time) {
+  switch (state_) {
+    case State::kConnecting:
+      if (current_time >= connect_deadline_) {
+        std::cerr << "Open-loop benchmark: the stream is not established\n";
+        state_ = State::kFinished;
+        aether_app_->Exit(1);
+        return current_time + std::chrono::seconds{1};
+      }
+      if (current_time >= next_probe_time_) {
+        SendProbe(current_time);
+      }
+      return std::min(next_probe_time_, connect_deadline_);
+    case State::kSending:
+      // if the loop was late, catch up by sending all the pings due
+      while ((stage_sent_count_ < stage_scheduled_count_) &&
+             (IntendedTime(stage_sent_count_) <= current_time)) {
+        auto sequence = next_sequence_++;
+        ping_table_.Add(sequence, IntendedTime(stage_sent_count_));
+        ++stage_sent_count_;
+        link_->Write(MakePing(sequence));
+      }
+      if (stage_sent_count_ < stage_scheduled_count_) {
+        return IntendedTime(stage_sent_count_);
+      }
+      state_ = State::kDraining;
+      drain_deadline_ = current_time + kDrainTimeout;
+      [[fallthrough]];
+    case State::kDraining:
+      if ((ping_table_.in_flight_count() == 0) ||
+          (current_time >= drain_deadline_)) {
+        FinishStage(current_time);
+        return current_time;
+      }
+      return drain_deadline_;
+    case State::kFinished:
+      break;
+  }
+  return current_time + std::chrono::seconds{1};
+}
+
+void RateBench::SendProbe(ae::TimePoint current_time) {
+  auto sequence = next_sequence_++;
+  ping_table_.Add(sequence, current_time);
+  link_->Write(MakePing(sequence));
+  next_probe_time_ = current_time + kProbeInterval;
+}
+
+void RateBench::StartStage(ae::TimePoint current_time) {
+  auto rate = config_.rates[stage_index_];
+  state_ = State::kSending;
+  histogram_.Reset();
+  ping_table_.ResetLost();
+  stage_first_sequence_ = next_sequence_;
+  stage_scheduled_count_ =
+      static_cast<std::size_t>(std::ceil(rate * config_.stage_duration)) +
+      config_.warmup_count;
+  stage_sent_count_ = 0;
+  stage_start_time_ = current_time;
+  stage_start_allocations_ = AllocationCount();
+  stage_start_library_allocations_ = LibraryAllocationCount();
+}
+
+void RateBench::FinishStage(ae::TimePoint current_time) {
+  ping_table_.Expire();
+
+  auto elapsed = std::chrono::duration_cast<std::chrono::duration<double>>(
+      current_time - stage_start_time_);
+  auto received_count = stage_sent_count_ - ping_table_.lost_count();
+  auto allocations =
+      static_cast<double>(AllocationCount() - stage_start_allocations_);
+  auto library_allocations = static_cast<double>(
+      LibraryAllocationCount() - stage_start_library_allocations_);
+  auto sent_count = static_cast<double>(stage_sent_count_);
+  results_.push_back(StageResult{
+      config_.rates[stage_index_],
+      static_cast<double>(received_count) / elapsed.count(),
+      ping_table_.lost_count(),
+      allocations / sent_count,
+      library_allocations / sent_count,
+      histogram_,
+  });
+
+  std::cout << ae::Format(
+      "Rate {:.1f} msg/s: {} measured, {} lost, {:.2f} allocations per ping, "
+      "{:.2f} of them by the client library\n",
+      config_.rates[stage_index_], histogram_.count(),
+      ping_table_.lost_count(), results_.back().allocations_per_ping,
+      results_.back().library_allocations_per_ping);
+  PrintLatencyReport(histogram_);
+
+  if (++stage_index_ < config_.rates.size()) {
+    StartStage(current_time);
+    return;
+  }
+  PrintCurve();
+  state_ = State::kFinished;
+  aether_app_->Exit(0);
+}
+
+ae::TimePoint RateBench::IntendedTime(std::size_t index) const {
+  auto offset = std::chrono::duration<double>{static_cast<double>(index) /
+                                              config_.rates[stage_index_]};
+  return stage_start_time_ +
+         std::chrono::duration_cast<ae::TimePoint::duration>(offset);
+}
+
+void RateBench::PongReceived(ae::DataBuffer const& data_buffer) {
+  auto current_time = ae::Now();
+  auto sequence = ReadPingSequence(data_buffer);
+  if (!sequence) {
+    return;
+  }
+  auto intended_time = ping_table_.Remove(*sequence);
+  if (!intended_time) {
+    return;
+  }
+
+  if (state_ == State::kConnecting) {
+    // the other probes are not a part of any stage
+    ping_table_.Expire();
+    StartStage(current_time);
+    return;
+  }
+  if (state_ == State::kFinished) {
+    return;
+  }
+  if ((*sequence - stage_first_sequence_) >= config_.warmup_count) {
+    histogram_.Record(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        current_time - *intended_time));
+  }
+}
+
+void RateBench::CollectResults(BenchResults& results) const {
+  for (auto const& result : results_) {
+    auto prefix = ae::Format("rate.{}", result.target_rate);
+    results.Add(prefix + ".achieved", result.achieved_rate, "msg/s",
+                MetricGoal::kHigher);
+    results.Add(prefix + ".lost", static_cast<double>(result.lost_count), "",
+                MetricGoal::kLower);
+    results.Add(prefix + ".allocations", result.allocations_per_ping,
+                "per ping", MetricGoal::kLower);
+    results.Add(prefix + ".library_allocations",
+                result.library_allocations_per_ping, "per ping",
+                MetricGoal::kLower);
+    results.AddLatency(prefix, result.histogram);
+  }
+}
+
+void RateBench::PrintCurve() const {
+  std::cout << "Rate versus latency (from intended send time, us):\n";
+  std::cout << ae::Format("{:>10} {:>10} {:>10} {:>10} {:>10} {:>10} {:>8}\n",
+                          "target", "achieved", "p50", "p99", "p99.9", "max",
+                          "lost");
+  for (auto const& result : results_) {
+    auto const& histogram = result.histogram;
+    std::cout << ae::Format(
+        "{:>10.1f} {:>10.1f} {:>10.1f} {:>10.1f} {:>10.1f} {:>10.1f} {:>8}\n",
+        result.target_rate, result.achieved_rate,
+        ToMicros(histogram.Percentile(50.0)),
+        ToMicros(histogram.Percentile(99.0)),
+        ToMicros(histogram.Percentile(99.9)), ToMicros(histogram.max()),
+        result.lost_count);
+  }
+}
@@ -0,0 +1,102 @@
+/*
+ * Copyright 2025 Aethernet Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef BENCH_RATE_BENCH_H_
+#define BENCH_RATE_BENCH_H_
+
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+#include "aether/all.h"
+
+#include "bench/bench_link.h"
+#include "bench/ping_table.h"
+#include "bench/bench_config.h"
+#include "bench/bench_results.h"
+#include "bench/latency_histogram.h"
+
+/**
+ * \brief Open-loop constant rate load generator.
+ * Pings are sent on a fixed schedule whether or not answers have arrived, and
+ * latency is measured from the intended send time, so a stalled sender shows up
+ * in the numbers instead of hiding it (no coordinated omission). A stage is run
+ * per configured rate and at the end the rate versus latency curve is printed.
+ * Before the first stage a probe ping is sent each second until one is
+ * answered, and the application exits with an error if none is answered
+ * within a timeout.
+ */
+class RateBench {
+ public:
+  RateBench(ae::AetherApp& aether_app, BenchLink& link,
+            BenchConfig const& config);
+
+  /**
+   * \brief Send all the pings due by current_time.
+   * Must be called on each application loop iteration.
+   * Returns the time it should be called next.
+   */
+  ae::TimePoint Update(ae::TimePoint current_time);
+
+  void CollectResults(BenchResults& results) const;
+
+ private:
+  enum class State {
+    kConnecting,  // wait for a probe ping to establish the stream
+    kSending,
+    kDraining,  // wait for the answers to the last pings
+    kFinished,
+  };
+
+  struct StageResult {
+    double target_rate;
+    double achieved_rate;
+    std::size_t lost_count;
+    double allocations_per_ping;
+    double library_allocations_per_ping;
+    LatencyHistogram histogram;
+  };
+
+  void SendProbe(ae::TimePoint current_time);
+  void StartStage(ae::TimePoint current_time);
+  void FinishStage(ae::TimePoint current_time);
+  ae::TimePoint IntendedTime(std::size_t index) const;
+  void PongReceived(ae::DataBuffer const& data_buffer);
+  void PrintCurve() const;
+
+  ae::AetherApp* aether_app_;
+  BenchLink* link_;
+  BenchConfig config_;
+
+  State state_{State::kConnecting};
+  PingTable ping_table_;
+  std::uint32_t next_sequence_{};
+  ae::TimePoint connect_deadline_;
+  ae::TimePoint next_probe_time_;
+
+  std::size_t stage_index_{};
+  std::uint32_t stage_first_sequence_{};
+  std::size_t stage_scheduled_count_{};
+  std::size_t stage_sent_count_{};
+  ae::TimePoint stage_start_time_;
+  std::uint64_t stage_start_allocations_{};
+  std::uint64_t stage_start_library_allocations_{};
+  ae::TimePoint drain_deadline_;
+  LatencyHistogram histogram_;
+  std::vector<StageResult> results_;
+};
+
+#endif  // BENCH_RATE_BENCH_H_
@@ -0,0 +1,133 @@
+/*
+ * Copyright 2025 Aethernet Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "bench/threads_bench.h"
+
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <barrier>
+#include <iostream>
+#include <algorithm>
+
+#if defined __linux__
+#  include <pthread.h>
+#  include <sched.h>
+#elif defined _WIN32
+#  include <windows.h>
+#endif
+
+#include "bench/pairs_bench.h"
+
+namespace {
+bool PinThreadToCore(std::size_t core) {
+#if defined __linux__
+  cpu_set_t cpu_set;
+  CPU_ZERO(&cpu_set);
+  CPU_SET(core, &cpu_set);
+  return pthread_setaffinity_np(pthread_self(), sizeof(cpu_set), &cpu_set) ==
+         0;
+#elif defined _WIN32
+  return SetThreadAffinityMask(GetCurrentThread(), DWORD_PTR{1} << core) != 0;
+#else
+  // thread affinity is not supported
+  (void)core;
+  return false;
+#endif
+}
+}  // namespace
+
+int RunThreadsBench(ae::Uid parent_uid, BenchConfig const& config,
+                    BenchResults& bench_results) {
+  auto thread_count = config.thread_count;
+  auto core_count = std::max(std::thread::hardware_concurrency(), 1U);
+  std::cout << ae::Format("Threads benchmark: {} applications on {} cores\n",
+                          thread_count, core_count);
+
+  std::vector<std::vector<PairsStageResult>> results(thread_count);
+  std::vector<int> exit_codes(thread_count);
+  std::barrier stage_barrier{static_cast<std::ptrdiff_t>(thread_count)};
+  // applications load the same saved state on construction, and one of them
+  // saves it, so the storage is never read and written at once
+  std::mutex storage_mutex;
+
+  std::vector<std::thread> threads;
+  threads.reserve(thread_count);
+  for (std::size_t i = 0; i < thread_count; ++i) {
+    threads.emplace_back([&, i]() {
+      if (!PinThreadToCore(i % core_count)) {
+        std::cerr << ae::Format("Thread {} is not pinned to a core\n", i);
+      }
+
+      ae::RcPtr<ae::AetherApp> aether_app;
+      {
+        auto lock = std::scoped_lock{storage_mutex};
+        aether_app = ae::AetherApp::Construct(ae::AetherAppContext{});
+      }
+
+      auto pairs_bench = PairsBench{
+          *aether_app, parent_uid, config,
+          PairsBenchOptions{
+              "T" + std::to_string(i) + "_",
+              [&]() { stage_barrier.arrive_and_wait(); },
+              false,
+              // the saves of the others would overwrite each other's clients
+              i == 0,
+              &storage_mutex,
+          }};
+
+      while (!aether_app->IsExited()) {
+        auto current_time = ae::Now();
+        auto next_time = aether_app->Update(current_time);
+        pairs_bench.OnAppUpdate(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(
+                ae::Now() - current_time));
+        next_time = std::min(next_time, pairs_bench.Update(current_time));
+        aether_app->WaitUntil(next_time);
+      }
+
+      // do not hold the other threads if this one has stopped early
+      stage_barrier.arrive_and_drop();
+      results[i] = pairs_bench.results();
+      exit_codes[i] = aether_app->ExitCode();
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  for (std::size_t stage = 0; stage < config.pair_counts.size(); ++stage) {
+    std::size_t thread_results = 0;
+    PairsStageResult total{};
+    for (auto const& thread_result : results) {
+      if (stage < thread_result.size()) {
+        MergePairsStageResult(total, thread_result[stage]);
+        ++thread_results;
+      }
+    }
+    std::cout << ae::Format("Threads {} of {} finished stage {}\n",
+                            thread_results, thread_count, stage);
+    if (thread_results == 0) {
+      // an empty total would be reported as the stage's result
+      continue;
+    }
+    PrintPairsStageResult(total);
+    AddPairsStageResult(bench_results, total);
+  }
+
+  return *std::max_element(std::begin(exit_codes), std::end(exit_codes));
+}
@@ -0,0 +1,36 @@
+/*
+ * Copyright 2025 Aethernet Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef BENCH_THREADS_BENCH_H_
+#define BENCH_THREADS_BENCH_H_
+
+#include "aether/all.h"
+
+#include "bench/bench_config.h"
+#include "bench/bench_results.h"
+
+/**
+ * \brief Run the pairs benchmark in config.thread_count independent
+ * applications.
+ * Each application lives on its own thread pinned to a core and has its own
+ * client pairs. Stages are started on all threads together and the results
+ * are aggregated into one report and added to results.
+ * Returns the process exit code.
+ */
+int RunThreadsBench(ae::Uid parent_uid, BenchConfig const& config,
+                    BenchResults& results);
+
+#endif  // BENCH_THREADS_BENCH_H_
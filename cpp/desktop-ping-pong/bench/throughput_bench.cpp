@@ -0,0 +1,205 @@
+/*
+ * Copyright 2025 Aethernet Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "bench/throughput_bench.h"
+
+#include <iostream>
+#include <algorithm>
+
+#include "alloc_counter.h"
+
+#include "bench/cpu_time.h"
+
+namespace {
+// even the largest payload is sent enough times to get a stable number
+constexpr std::size_t kMinStageMessages = 100;
+// the acknowledgements have stopped if none comes for this time
+constexpr auto kAckTimeout = std::chrono::seconds{5};
+// the first acknowledgement also waits for the stream to be established
+constexpr auto kConnectTimeout = std::chrono::seconds{30};
+}  // namespace
+
+ThroughputBench::ThroughputBench(ae::AetherApp& aether_app, BenchLink& link,
+                                 BenchConfig const& config)
+    : aether_app_{&aether_app},
+      link_{&link},
+      config_{config},
+      ping_table_{config_.throughput_window * 4} {
+  link_->set_receiver(
+      [this](ae::DataBuffer const& data) { AckReceived(data); });
+  std::cout << ae::Format(
+      "Throughput benchmark: {} payload sizes, {} bytes each, window {}\n",
+      config_.payload_sizes.size(), config_.stage_bytes,
+      config_.throughput_window);
+  // stages start only after the stream is established
+  last_ack_time_ = ae::Now();
+  auto sequence = next_sequence_++;
+  ping_table_.Add(sequence, ae::Now());
+  link_->Write(MakePing(sequence));
+}
+
+void ThroughputBench::StartStage() {
+  auto payload_size = config_.payload_sizes[stage_index_];
+  stage_message_count_ =
+      std::max(config_.stage_bytes / payload_size, kMinStageMessages);
+  stage_sent_count_ = 0;
+  ping_table_.ResetLost();
+  stage_start_time_ = ae::Now();
+  last_ack_time_ = stage_start_time_;
+  stage_start_cpu_time_ = ProcessCpuTime();
+  stage_start_allocations_ = AllocationCount();
+  stage_start_library_allocations_ = LibraryAllocationCount();
+  FillWindow();
+}
+
+void ThroughputBench::FillWindow() {
+  auto payload_size = config_.payload_sizes[stage_index_];
+  while ((ping_table_.in_flight_count() < config_.throughput_window) &&
+         (stage_sent_count_ < stage_message_count_)) {
+    auto sequence = next_sequence_++;
+    ping_table_.Add(sequence, ae::Now());
+    ++stage_sent_count_;
+    link_->Write(MakePing(sequence, payload_size));
+  }
+}
+
+void ThroughputBench::AckReceived(ae::DataBuffer const& data_buffer) {
+  auto sequence = ReadPingSequence(data_buffer);
+  if (!sequence || !ping_table_.Remove(*sequence)) {
+    return;
+  }
+  last_ack_time_ = ae::Now();
+
+  if (!connected_) {
+    connected_ = true;
+    StartStage();
+    return;
+  }
+
+  FillWindow();
+  if (ping_table_.in_flight_count() == 0) {
+    FinishStage();
+  }
+}
+
+ae::TimePoint ThroughputBench::Update(ae::TimePoint current_time) {
+  if (finished_ || (ping_table_.in_flight_count() == 0)) {
+    return current_time + kAckTimeout;
+  }
+  auto deadline =
+      last_ack_time_ + (connected_ ? kAckTimeout : kConnectTimeout);
+  if (current_time < deadline) {
+    return deadline;
+  }
+  // count the unacknowledged messages as lost and go on
+  ping_table_.Expire();
+  last_ack_time_ = current_time;
+  if (!connected_) {
+    std::cerr << "Throughput benchmark: the stream is not established\n";
+    finished_ = true;
+    aether_app_->Exit(1);
+  } else if (stage_sent_count_ < stage_message_count_) {
+    FillWindow();
+  } else {
+    FinishStage();
+  }
+  return current_time;
+}
+
+void ThroughputBench::FinishStage() {
+  auto result = StageResult{
+      config_.payload_sizes[stage_index_],
+      stage_sent_count_ - ping_table_.lost_count(),
+      ping_table_.lost_count(),
+      std::chrono::duration_cast<std::chrono::duration<double>>(
+          ae::Now() - stage_start_time_),
+      ProcessCpuTime() - stage_start_cpu_time_,
+      AllocationCount() - stage_start_allocations_,
+      LibraryAllocationCount() - stage_start_library_allocations_,
+  };
+  results_.push_back(result);
+  std::cout << ae::Format("Payload {} B: {} messages in {:.3f} s, {} lost\n",
+                          result.payload_size, result.message_count,
+                          result.elapsed.count(), result.lost_count);
+
+  if (++stage_index_ < config_.payload_sizes.size()) {
+    StartStage();
+    return;
+  }
+  PrintResults();
+  finished_ = true;
+  aether_app_->Exit(0);
+}
+
+void ThroughputBench::CollectResults(BenchResults& results) const {
+  for (auto const& result : results_) {
+    auto bytes =
+        static_cast<double>(result.payload_size * result.message_count);
+    auto seconds = result.elapsed.count();
+    auto prefix = ae::Format("throughput.{}", result.payload_size);
+    results.Add(prefix + ".mb_per_s",
+                (seconds > 0) ? bytes / seconds / 1e6 : 0.0, "MB/s",
+                MetricGoal::kHigher);
+    results.Add(prefix + ".msg_per_s",
+                (seconds > 0)
+                    ? static_cast<double>(result.message_count) / seconds
+                    : 0.0,
+                "msg/s", MetricGoal::kHigher);
+    results.Add(prefix + ".lost", static_cast<double>(result.lost_count), "",
+                MetricGoal::kLower);
+    results.Add(prefix + ".cpu_per_byte",
+                (bytes > 0) ? static_cast<double>(result.cpu_time.count()) /
+                                  bytes
+                            : 0.0,
+                "ns", MetricGoal::kLower);
+    results.Add(prefix + ".allocations",
+                (result.message_count > 0)
+                    ? static_cast<double>(result.allocation_count) /
+                          static_cast<double>(result.message_count)
+                    : 0.0,
+                "per message", MetricGoal::kLower);
+    results.Add(prefix + ".library_allocations",
+                (result.message_count > 0)
+                    ? static_cast<double>(result.library_allocation_count) /
+                          static_cast<double>(result.message_count)
+                    : 0.0,
+                "per message", MetricGoal::kLower);
+  }
+}
+
+void ThroughputBench::PrintResults() const {
+  std::cout << "Throughput by payload size:\n";
+  std::cout << ae::Format("{:>10} {:>10} {:>12} {:>14} {:>10} {:>12}\n",
+                          "payload B", "MB/s", "msg/s", "CPU ns/byte",
+                          "allocs/msg", "library/msg");
+  for (auto const& result : results_) {
+    auto bytes =
+        static_cast<double>(result.payload_size * result.message_count);
+    auto seconds = result.elapsed.count();
+    auto messages = static_cast<double>(result.message_count);
+    std::cout << ae::Format(
+        "{:>10} {:>10.2f} {:>12.1f} {:>14.2f} {:>10.2f} {:>12.2f}\n",
+        result.payload_size, (seconds > 0) ? bytes / seconds / 1e6 : 0.0,
+        (seconds > 0) ? messages / seconds : 0.0,
+        (bytes > 0) ? static_cast<double>(result.cpu_time.count()) / bytes
+                    : 0.0,
+        (messages > 0) ? static_cast<double>(result.allocation_count) / messages
+                       : 0.0,
+        (messages > 0)
+            ? static_cast<double>(result.library_allocation_count) / messages
+            : 0.0);
+  }
+}
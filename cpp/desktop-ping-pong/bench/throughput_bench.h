@@ -0,0 +1,92 @@
+/*
+ * Copyright 2025 Aethernet Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef BENCH_THROUGHPUT_BENCH_H_
+#define BENCH_THROUGHPUT_BENCH_H_
+
+#include <chrono>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+#include "aether/all.h"
+
+#include "bench/bench_link.h"
+#include "bench/ping_table.h"
+#include "bench/bench_config.h"
+#include "bench/bench_results.h"
+
+/**
+ * \brief Bulk transfer benchmark over P2pStream.
+ * For each configured payload size Alice streams the stage's bytes to Bob,
+ * keeping a window of unacknowledged messages. Bob acknowledges each message
+ * with its sequence number only. Reports MB/s, messages/s and process CPU time
+ * per byte for each size, then exits the application.
+ * If no acknowledgement comes for a timeout, the messages in flight are
+ * counted as lost, so a lost message does not stall the window.
+ */
+class ThroughputBench {
+ public:
+  ThroughputBench(ae::AetherApp& aether_app, BenchLink& link,
+                  BenchConfig const& config);
+
+  /**
+   * \brief Expire the messages in flight if the acknowledgements have stopped.
+   * Returns the time it should be called next.
+   */
+  ae::TimePoint Update(ae::TimePoint current_time);
+
+  void CollectResults(BenchResults& results) const;
+
+ private:
+  struct StageResult {
+    std::size_t payload_size;
+    std::size_t message_count;
+    std::size_t lost_count;
+    std::chrono::duration<double> elapsed;
+    std::chrono::nanoseconds cpu_time;
+    std::uint64_t allocation_count;
+    std::uint64_t library_allocation_count;
+  };
+
+  void StartStage();
+  void FillWindow();
+  void AckReceived(ae::DataBuffer const& data_buffer);
+  void FinishStage();
+  void PrintResults() const;
+
+  ae::AetherApp* aether_app_;
+  BenchLink* link_;
+  BenchConfig config_;
+
+  bool connected_{};
+  bool finished_{};
+  // the last acknowledgement or the stage start
+  ae::TimePoint last_ack_time_;
+  PingTable ping_table_;
+  std::uint32_t next_sequence_{};
+
+  std::size_t stage_index_{};
+  std::size_t stage_message_count_{};
+  std::size_t stage_sent_count_{};
+  ae::TimePoint stage_start_time_;
+  std::chrono::nanoseconds stage_start_cpu_time_{};
+  std::uint64_t stage_start_allocations_{};
+  std::uint64_t stage_start_library_allocations_{};
+  std::vector<StageResult> results_;
+};
+
+#endif  // BENCH_THROUGHPUT_BENCH_H_
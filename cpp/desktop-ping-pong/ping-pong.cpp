@@ -14,14 +14,45 @@
  * limitations under the License.
  */
 
+#include <utility>
+#include <cstdint>
 #include <iostream>
+#include <algorithm>
 #include <string_view>
 
 #include "aether/all.h"
 
+#include "alloc_counter.h"
+#include "async_logger.h"
+
+#include "bench/bench_link.h"
+#include "bench/rate_bench.h"
+#include "bench/pairs_bench.h"
+#include "bench/bench_config.h"
+#include "bench/bench_results.h"
+#include "bench/threads_bench.h"
+#include "bench/latency_bench.h"
+#include "bench/throughput_bench.h"
+
 static constexpr auto kParentUid =
     ae::Uid::FromString("3ac93165-3d37-4970-87a6-fa4ee27744e4");
 
+static constexpr std::string_view kPingMessage = "ping";
+static constexpr std::string_view kPongMessage = "pong";
+
+// the received message as one of the constants above, so the log record keeps
+// a view of static text instead of a copy of the buffer
+static std::string_view KnownMessage(ae::DataBuffer const& data_buffer) {
+  auto message = std::string_view{
+      reinterpret_cast<char const*>(data_buffer.data()), data_buffer.size()};
+  for (auto known : {kPingMessage, kPongMessage}) {
+    if (message == known) {
+      return known;
+    }
+  }
+  return "unknown";
+}
+
 class TimeSynchronizer {
  public:
   TimeSynchronizer() = default;
@@ -57,10 +88,12 @@ class Alice {
 };
 
 // Bob answers "pong" to each "ping"
+// In echo mode Bob silently answers each message with its header - the ping's
+// sequence number, so large payloads are not sent back
 class Bob {
  public:
   explicit Bob(ae::AetherApp& aether_app, ae::Client::ptr client_bob,
-               TimeSynchronizer& time_synchronizer);
+               TimeSynchronizer& time_synchronizer, bool echo_mode = false);
 
  private:
   void OnNewStream(ae::P2pPortHandle p2p_port);
@@ -69,47 +102,133 @@ class Bob {
   ae::AetherApp* aether_app_;
   ae::Client::ptr client_bob_;
   TimeSynchronizer* time_synchronizer_;
+  bool echo_mode_;
   std::unique_ptr<ae::P2pStream> p2pstream_;
   ae::Subscription new_stream_receive_sub_;
   ae::Subscription message_receive_sub_;
 };
 
-int main() {
+int main(int argc, char const* argv[]) {
+  auto bench_config = ParseBenchConfig(argc, argv);
+  if (!bench_config) {
+    PrintBenchUsage(std::cerr, argv[0]);
+    return 1;
+  }
+  bool const is_bench = bench_config->mode != BenchMode::kDemo;
+  if (bench_config->thread_count > 1) {
+    BenchResults results;
+    auto exit_code = RunThreadsBench(kParentUid, *bench_config, results);
+    if (exit_code != 0) {
+      return exit_code;
+    }
+    return ReportBenchResults(*bench_config, std::move(results));
+  }
+
   auto aether_app = ae::AetherApp::Construct(ae::AetherAppContext{});
 
   std::unique_ptr<Alice> alice;
   std::unique_ptr<Bob> bob;
+  std::unique_ptr<BenchLink> bench_link;
+  std::unique_ptr<LatencyBench> latency_bench;
+  std::unique_ptr<RateBench> rate_bench;
+  std::unique_ptr<ThroughputBench> throughput_bench;
+  std::unique_ptr<PairsBench> pairs_bench;
   TimeSynchronizer time_synchronizer;
 
-  // register or load clients
-  auto& bob_select = aether_app->aether()->SelectClient(kParentUid, "Bob");
-  bob_select.result_event().Subscribe([&](auto const& bob_res) {
-    if (bob_res) {
-      bob =
-          ae::make_unique<Bob>(*aether_app, bob_res.value(), time_synchronizer);
-      auto& alice_select =
-          aether_app->aether()->SelectClient(kParentUid, "Alice");
-      alice_select.result_event().Subscribe(
-          [&, uid = bob_res.value()->uid()](auto const& alice_res) {
-            if (alice_res) {
-              alice = ae::make_unique<Alice>(*aether_app, alice_res.value(),
-                                             time_synchronizer, uid);
-              // Save the current aether state
-              aether_app->aether().Save();
-            } else {
-              aether_app->Exit(1);
-            }
-          });
-    } else {
-      aether_app->Exit(1);
+  auto start_bench = [&](ae::Client::ptr client, ae::Uid bobs_uid) {
+    bench_link =
+        ae::make_unique<BenchLink>(*aether_app, std::move(client), bobs_uid);
+    if (bench_config->mode == BenchMode::kLatency) {
+      latency_bench = ae::make_unique<LatencyBench>(*aether_app, *bench_link,
+                                                    *bench_config);
+    } else if (bench_config->mode == BenchMode::kRate) {
+      rate_bench =
+          ae::make_unique<RateBench>(*aether_app, *bench_link, *bench_config);
+    } else if (bench_config->mode == BenchMode::kThroughput) {
+      throughput_bench = ae::make_unique<ThroughputBench>(
+          *aether_app, *bench_link, *bench_config);
     }
-  });
+  };
+
+  if (bench_config->mode == BenchMode::kPairs) {
+    // pairs benchmark registers or loads its own clients
+    pairs_bench =
+        ae::make_unique<PairsBench>(*aether_app, kParentUid, *bench_config);
+  } else {
+    // register or load clients
+    auto& bob_select = aether_app->aether()->SelectClient(kParentUid, "Bob");
+    bob_select.result_event().Subscribe([&](auto const& bob_res) {
+      if (bob_res) {
+        bob = ae::make_unique<Bob>(*aether_app, bob_res.value(),
+                                   time_synchronizer, is_bench);
+        auto& alice_select =
+            aether_app->aether()->SelectClient(kParentUid, "Alice");
+        alice_select.result_event().Subscribe(
+            [&, uid = bob_res.value()->uid()](auto const& alice_res) {
+              if (alice_res) {
+                if (is_bench) {
+                  start_bench(alice_res.value(), uid);
+                } else {
+                  alice = ae::make_unique<Alice>(
+                      *aether_app, alice_res.value(), time_synchronizer, uid);
+                }
+                // Save the current aether state
+                aether_app->aether().Save();
+              } else {
+                aether_app->Exit(1);
+              }
+            });
+      } else {
+        aether_app->Exit(1);
+      }
+    });
+  }
 
   while (!aether_app->IsExited()) {
-    auto next_time = aether_app->Update(ae::Now());
+    auto current_time = ae::Now();
+    auto next_time = ae::TimePoint{};
+    {
+      auto library_scope = AllocationScope{AllocationScope::Owner::kLibrary};
+      next_time = aether_app->Update(current_time);
+    }
+    if (pairs_bench) {
+      pairs_bench->OnAppUpdate(
+          std::chrono::duration_cast<std::chrono::nanoseconds>(ae::Now() -
+                                                               current_time));
+      next_time = std::min(next_time, pairs_bench->Update(current_time));
+    }
+    if (latency_bench) {
+      next_time = std::min(next_time, latency_bench->Update(current_time));
+    }
+    if (rate_bench) {
+      next_time = std::min(next_time, rate_bench->Update(current_time));
+    }
+    if (throughput_bench) {
+      next_time = std::min(next_time, throughput_bench->Update(current_time));
+    }
+    auto library_scope = AllocationScope{AllocationScope::Owner::kLibrary};
     aether_app->WaitUntil(next_time);
   }
-  return aether_app->ExitCode();
+  if (!is_bench || (aether_app->ExitCode() != 0)) {
+    return aether_app->ExitCode();
+  }
+
+  BenchResults results;
+  if (latency_bench) {
+    latency_bench->CollectResults(results);
+  }
+  if (rate_bench) {
+    rate_bench->CollectResults(results);
+  }
+  if (throughput_bench) {
+    throughput_bench->CollectResults(results);
+  }
+  if (pairs_bench) {
+    for (auto const& stage_result : pairs_bench->results()) {
+      AddPairsStageResult(results, stage_result);
+    }
+  }
+  return ReportBenchResults(*bench_config, std::move(results));
 }
 
 void TimeSynchronizer::SetPingSentTime(ae::TimePoint ping_sent_time) {
@@ -138,31 +257,38 @@ Alice::Alice(ae::AetherApp& aether_app, ae::Client::ptr client_alice,
           ae::MethodPtr<&Alice::ResponseReceived>{this})} {}
 
 void Alice::SendMessage() {
+  // called from the library's update by the interval task
+  auto app_scope = AllocationScope{AllocationScope::Owner::kApplication};
   auto current_time = ae::Now();
-  constexpr std::string_view ping_message = "ping";
-
   time_synchronizer_->SetPingSentTime(current_time);
 
-  std::cout << ae::Format("[{:%H:%M:%S}] Alice sends \"ping\"'\n", ae::Now());
-  p2pstream_.Write({std::begin(ping_message), std::end(ping_message)});
+  Logger().Log([current_time]() {
+    return ae::Format("[{:%H:%M:%S}] Alice sends \"ping\"'\n", current_time);
+  });
+  auto ping = ae::DataBuffer{std::begin(kPingMessage), std::end(kPingMessage)};
+  auto library_scope = AllocationScope{AllocationScope::Owner::kLibrary};
+  p2pstream_.Write(std::move(ping));
 }
 
 void Alice::ResponseReceived(ae::DataBuffer const& data_buffer) {
-  auto pong_message = std::string_view{
-      reinterpret_cast<char const*>(data_buffer.data()), data_buffer.size()};
-  std::cout << ae::Format(
-      "[{:%H:%M:%S}] Alice received \"{}\" within time {} ms\n", ae::Now(),
-      pong_message,
-      std::chrono::duration_cast<std::chrono::milliseconds>(
-          time_synchronizer_->GetPongDuration())
-          .count());
+  // called from the library's update
+  auto app_scope = AllocationScope{AllocationScope::Owner::kApplication};
+  auto pong_message = KnownMessage(data_buffer);
+  auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(
+      time_synchronizer_->GetPongDuration());
+  Logger().Log([time = ae::Now(), pong_message, duration]() {
+    return ae::Format(
+        "[{:%H:%M:%S}] Alice received \"{}\" within time {} ms\n", time,
+        pong_message, duration.count());
+  });
 }
 
 Bob::Bob(ae::AetherApp& aether_app, ae::Client::ptr client_bob,
-         TimeSynchronizer& time_synchronizer)
+         TimeSynchronizer& time_synchronizer, bool echo_mode)
     : aether_app_{&aether_app},
       client_bob_{std::move(client_bob)},
       time_synchronizer_{&time_synchronizer},
+      echo_mode_{echo_mode},
       new_stream_receive_sub_{
           client_bob_->message_stream_manager().new_port_event().Subscribe(
               ae::MethodPtr<&Bob::OnNewStream>{this})} {}
@@ -176,17 +302,31 @@ void Bob::OnNewStream(ae::P2pPortHandle p2p_port) {
 }
 
 void Bob::OnMessageReceived(ae::DataBuffer const& data_buffer) {
-  auto ping_message = std::string_view{
-      reinterpret_cast<char const*>(data_buffer.data()), data_buffer.size()};
-  std::cout << ae::Format(
-      "[{:%H:%M:%S}] Bob received \"{}\" within time {} ms\n", ae::Now(),
-      ping_message,
-      std::chrono::duration_cast<std::chrono::milliseconds>(
-          time_synchronizer_->GetPingDuration())
-          .count());
-
-  time_synchronizer_->SetPongSentTime(ae::Now());
-  constexpr std::string_view pong_message = "pong";
-  std::cout << ae::Format("[{:%H:%M:%S}] Bob sends \"pong\"\n", ae::Now());
-  p2pstream_->Write({std::begin(pong_message), std::end(pong_message)});
+  // called from the library's update
+  auto app_scope = AllocationScope{AllocationScope::Owner::kApplication};
+  if (echo_mode_) {
+    auto header_size = std::min(data_buffer.size(), sizeof(std::uint32_t));
+    auto header = ae::DataBuffer{std::begin(data_buffer),
+                                 std::begin(data_buffer) + header_size};
+    auto library_scope = AllocationScope{AllocationScope::Owner::kLibrary};
+    p2pstream_->Write(std::move(header));
+    return;
+  }
+
+  auto ping_message = KnownMessage(data_buffer);
+  auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(
+      time_synchronizer_->GetPingDuration());
+  Logger().Log([time = ae::Now(), ping_message, duration]() {
+    return ae::Format("[{:%H:%M:%S}] Bob received \"{}\" within time {} ms\n",
+                      time, ping_message, duration.count());
+  });
+
+  auto current_time = ae::Now();
+  time_synchronizer_->SetPongSentTime(current_time);
+  Logger().Log([current_time]() {
+    return ae::Format("[{:%H:%M:%S}] Bob sends \"pong\"\n", current_time);
+  });
+  auto pong = ae::DataBuffer{std::begin(kPongMessage), std::end(kPongMessage)};
+  auto library_scope = AllocationScope{AllocationScope::Owner::kLibrary};
+  p2pstream_->Write(std::move(pong));
 }
@@ -0,0 +1,76 @@
+/*
+ * Copyright 2025 Aethernet Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef BENCH_COMMUTATOR_REQUESTS_H_
+#define BENCH_COMMUTATOR_REQUESTS_H_
+
+#include <vector>
+#include <cstdint>
+
+#include "aether/all.h"
+
+#include "api/api.h"
+#include "api/types.h"
+
+namespace ae {
+/**
+ * \brief Client side of SmartHomeCommutatorApi, to encode requests.
+ * Method ids are the ones of SmartHomeCommutatorApi in api/api.h.
+ */
+class CommutatorRequestApi : public ApiClass {
+ public:
+  explicit CommutatorRequestApi(ProtocolContext& protocol_context)
+      : ApiClass{protocol_context},
+        get_system_structure{protocol_context},
+        execute_actor_command{protocol_context},
+        execute_actor_command_with_priority{protocol_context},
+        query_state{protocol_context},
+        query_all_sensor_states{protocol_context},
+        query_all_sensor_states_batch{protocol_context},
+        query_all_sensor_states_packed{protocol_context},
+        subscribe_state{protocol_context},
+        get_metrics{protocol_context} {}
+
+  Method<SmartHomeCommutatorApi::kGetSystemStructureId,
+         PromiseView<std::vector<HardwareDevice>>()>
+      get_system_structure;
+  Method<SmartHomeCommutatorApi::kExecuteActorCommandId,
+         PromiseView<DeviceStateData>(int local_actor_id, VariantData command)>
+      execute_actor_command;
+  Method<SmartHomeCommutatorApi::kExecuteActorCommandWithPriorityId,
+         PromiseView<DeviceStateData>(int local_actor_id, VariantData command,
+                                      std::uint8_t priority)>
+      execute_actor_command_with_priority;
+  Method<SmartHomeCommutatorApi::kQueryStateId,
+         PromiseView<DeviceStateData>(int local_device_id)>
+      query_state;
+  Method<SmartHomeCommutatorApi::kQueryAllSensorStatesId, void()>
+      query_all_sensor_states;
+  Method<SmartHomeCommutatorApi::kQueryAllSensorStatesBatchId, void()>
+      query_all_sensor_states_batch;
+  Method<SmartHomeCommutatorApi::kQueryAllSensorStatesPackedId, void()>
+      query_all_sensor_states_packed;
+  Method<SmartHomeCommutatorApi::kSubscribeStateId,
+         void(int local_device_id, std::uint32_t min_interval_ms,
+              double deadband)>
+      subscribe_state;
+  Method<SmartHomeCommutatorApi::kGetMetricsId,
+         PromiseView<CommutatorMetrics>()>
+      get_metrics;
+};
+}  // namespace ae
+
+#endif  // BENCH_COMMUTATOR_REQUESTS_H_
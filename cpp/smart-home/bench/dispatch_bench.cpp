@@ -0,0 +1,276 @@
+/*
+ * Copyright 2025 Aethernet Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * Cost of the commutator's request path per API method: a pre-encoded request
+ * is delivered by a fake stream to Commutator::OnNewMessage, decoded by
+ * ApiParser, dispatched to CommutatorApiImpl with fake devices and answered
+ * into the same stream, without the network. Then the cost of encoding the
+ * ReturnResultApi::SendResult replies alone, and the cost per recipient of
+ * pushing a subscribed device state to 1 to 1000 subscribers.
+ * Run it before and after changing api/types.h or the dispatch code.
+ * Usage: smart-home-dispatch-bench [request count]
+ */
+
+#include <array>
+#include <chrono>
+#include <memory>
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <utility>
+#include <iostream>
+#include <algorithm>
+#include <functional>
+#include <string_view>
+
+#include "aether/all.h"
+
+#include "alloc_counter.h"
+
+#include "commutator.h"
+#include "device_io_executor.h"
+#include "bench/fake_stream.h"
+#include "bench/commutator_requests.h"
+#include "temperature/temperature_factory.h"
+
+namespace {
+constexpr auto kClientUid =
+    ae::Uid::FromString("b6a9c0f4-3a7e-4c1e-9d59-2f0d7b4c8e11");
+constexpr std::size_t kDefaultRequestCount = 100000;
+// fake sensors of the commutator, the all states requests read each of them
+constexpr std::size_t kDeviceCount = 8;
+// requests sent before the measurement to fill the caches and pools
+constexpr std::size_t kWarmupCount = 1000;
+// state updates pushed for each subscriber count
+constexpr std::size_t kFanOutRecipients = 200000;
+constexpr std::array<std::size_t, 4> kSubscriberCounts{1, 10, 100, 1000};
+
+struct RequestKind {
+  std::string_view name;
+  std::function<void(ae::ApiContext<ae::CommutatorRequestApi>&)> encode;
+};
+
+ae::DataBuffer EncodeRequest(ae::ProtocolContext& protocol_context,
+                             RequestKind const& kind) {
+  auto request_api = ae::CommutatorRequestApi{protocol_context};
+  auto api_context = ae::ApiContext{request_api};
+  kind.encode(api_context);
+  return std::move(api_context);
+}
+
+// run func count times, return ns and allocations per call
+template <typename Func>
+std::pair<double, double> Measure(std::size_t count, Func&& func) {
+  auto start_allocations = AllocationCount();
+  auto start_time = std::chrono::steady_clock::now();
+  for (std::size_t i = 0; i < count; ++i) {
+    func();
+  }
+  auto elapsed = std::chrono::duration<double, std::nano>{
+      std::chrono::steady_clock::now() - start_time};
+  auto calls = static_cast<double>(count);
+  return {elapsed.count() / calls,
+          static_cast<double>(AllocationCount() - start_allocations) / calls};
+}
+
+void RunDispatch(std::size_t request_count) {
+  auto action_processor = ae::ActionProcessor{};
+  auto action_context = ae::ActionContext{action_processor};
+
+  auto config = ae::CommutatorConfig{};
+  // measure the command path, not the rate limit
+  config.actor_command_interval = ae::Duration::zero();
+  auto commutator = ae::Commutator{action_context, config};
+  // the fake sensors don't block, run their reads inline
+  auto io_executor = ae::DeviceIoExecutor{0};
+  for (std::size_t i = 0; i < kDeviceCount; ++i) {
+    auto temp_sensor_config =
+        ae::TempSensorConfig{ae::TempSensorType::kFakeTempSensor};
+    commutator.AddDevice(ae::TemperatureFactory::CreateDevice(
+        action_context, io_executor, &temp_sensor_config));
+  }
+
+  auto stream = ae::FakeStream{action_context};
+  commutator.AddStream(kClientUid, stream);
+
+  auto request_kinds = std::array{
+      RequestKind{"GetSystemStructure",
+                  [](auto& api) { api->get_system_structure(); }},
+      RequestKind{"ExecuteActorCommand",
+                  [](auto& api) {
+                    api->execute_actor_command(
+                        0, ae::VariantData{ae::VariantBool{true}});
+                  }},
+      RequestKind{"ExecuteActorCommandWithPriority",
+                  [](auto& api) {
+                    api->execute_actor_command_with_priority(
+                        0, ae::VariantData{ae::VariantBool{true}}, 2);
+                  }},
+      RequestKind{"QueryState", [](auto& api) { api->query_state(0); }},
+      RequestKind{"QueryAllSensorStates",
+                  [](auto& api) { api->query_all_sensor_states(); }},
+      RequestKind{"QueryAllSensorStatesBatch",
+                  [](auto& api) { api->query_all_sensor_states_batch(); }},
+      RequestKind{"QueryAllSensorStatesPacked",
+                  [](auto& api) { api->query_all_sensor_states_packed(); }},
+      RequestKind{"GetMetrics", [](auto& api) { api->get_metrics(); }},
+  };
+
+  auto protocol_context = ae::ProtocolContext{};
+  std::cout << ae::Format(
+      "Dispatch benchmark: {} requests per method, {} devices\n",
+      request_count, kDeviceCount);
+  std::cout << ae::Format("{:>32} {:>12} {:>10} {:>12} {:>8}\n", "request",
+                          "req/s", "ns/op", "allocs/op", "replies");
+  for (auto const& kind : request_kinds) {
+    auto message = EncodeRequest(protocol_context, kind);
+    auto send = [&](std::size_t count) {
+      for (std::size_t i = 0; i < count; ++i) {
+        stream.Receive(message);
+        // complete the state reads and send the replies
+        action_processor.Update(ae::Now());
+      }
+    };
+
+    send(kWarmupCount);
+    auto start_writes = stream.write_count();
+    auto [ns, allocations] = Measure(1, [&]() { send(request_count); });
+    ns /= static_cast<double>(request_count);
+    allocations /= static_cast<double>(request_count);
+    std::cout << ae::Format("{:>32} {:>12.0f} {:>10.1f} {:>12.2f} {:>8}\n",
+                            kind.name, 1e9 / ns, ns, allocations,
+                            stream.write_count() - start_writes);
+  }
+}
+
+/**
+ * Cost of encoding the replies, without parsing and dispatching.
+ */
+void RunReplyEncoding(std::size_t reply_count) {
+  auto protocol_context = ae::ProtocolContext{};
+  auto return_api = ae::ReturnResultApi{protocol_context};
+
+  auto state = ae::DeviceStateData{
+      ae::VariantData{ae::VariantDouble{21.5}}, 1750000000};
+  std::vector<ae::HardwareDevice> structure;
+  for (std::size_t i = 0; i < kDeviceCount; ++i) {
+    auto sensor = ae::HardwareSensor{};
+    sensor.local_id = static_cast<int>(i);
+    sensor.descriptor = "Fake temperature sensor";
+    sensor.unit = "°C";
+    structure.emplace_back(sensor);
+  }
+
+  // keeps the results alive, so the calls are not optimized out
+  std::size_t check_sum = 0;
+  auto encode_reply = [&](auto const& value) {
+    auto api_context = ae::ApiContext{return_api};
+    api_context->SendResult(ae::RequestId{1}, value);
+    auto message = ae::DataBuffer{std::move(api_context)};
+    check_sum += message.size();
+  };
+
+  std::cout << "Reply encoding benchmark\n";
+  std::cout << ae::Format("{:>32} {:>10} {:>12}\n", "reply", "ns/op",
+                          "allocs/op");
+  auto [state_ns, state_allocations] =
+      Measure(reply_count, [&]() { encode_reply(state); });
+  std::cout << ae::Format("{:>32} {:>10.1f} {:>12.2f}\n", "DeviceStateData",
+                          state_ns, state_allocations);
+  auto [structure_ns, structure_allocations] =
+      Measure(reply_count, [&]() { encode_reply(structure); });
+  std::cout << ae::Format("{:>32} {:>10.1f} {:>12.2f}\n",
+                          ae::Format("{} HardwareDevice", kDeviceCount),
+                          structure_ns, structure_allocations);
+  std::cout << ae::Format("(check {})\n", check_sum);
+}
+
+/**
+ * Cost of pushing one device state update to each of the subscribers.
+ */
+void RunFanOut() {
+  std::cout << "Fan-out benchmark: one device state pushed to subscribers\n";
+  std::cout << ae::Format("{:>12} {:>14} {:>18}\n", "subscribers",
+                          "ns/recipient", "allocs/recipient");
+  for (auto subscriber_count : kSubscriberCounts) {
+    auto action_processor = ae::ActionProcessor{};
+    auto action_context = ae::ActionContext{action_processor};
+    auto config = ae::CommutatorConfig{};
+    config.max_stream_count = subscriber_count;
+    auto commutator = ae::Commutator{action_context, config};
+    auto io_executor = ae::DeviceIoExecutor{0};
+    auto temp_sensor_config =
+        ae::TempSensorConfig{ae::TempSensorType::kFakeTempSensor};
+    commutator.AddDevice(ae::TemperatureFactory::CreateDevice(
+        action_context, io_executor, &temp_sensor_config));
+
+    // each subscriber gets each state, checked on each update
+    auto protocol_context = ae::ProtocolContext{};
+    auto subscribe = EncodeRequest(
+        protocol_context,
+        RequestKind{"SubscribeState",
+                    [](auto& api) { api->subscribe_state(0, 0, -1.0); }});
+    std::vector<std::unique_ptr<ae::FakeStream>> streams;
+    for (std::size_t i = 0; i < subscriber_count; ++i) {
+      auto& stream = streams.emplace_back(
+          std::make_unique<ae::FakeStream>(action_context));
+      commutator.AddStream(
+          ae::Uid::FromString(
+              ae::Format("00000000-0000-4000-8000-{:012x}", i + 1)),
+          *stream);
+      stream->Receive(subscribe);
+    }
+
+    auto push_round = [&]() {
+      auto current_time = ae::Now();
+      commutator.Update(current_time);
+      action_processor.Update(current_time);
+    };
+    for (std::size_t i = 0; i < 10; ++i) {
+      push_round();
+    }
+
+    auto rounds =
+        std::max(kFanOutRecipients / subscriber_count, std::size_t{1});
+    auto start_allocations = AllocationCount();
+    auto start_time = std::chrono::steady_clock::now();
+    for (std::size_t i = 0; i < rounds; ++i) {
+      push_round();
+    }
+    auto elapsed = std::chrono::duration<double, std::nano>{
+        std::chrono::steady_clock::now() - start_time};
+
+    auto recipients = static_cast<double>(rounds * subscriber_count);
+    std::cout << ae::Format(
+        "{:>12} {:>14.1f} {:>18.2f}\n", subscriber_count,
+        elapsed.count() / recipients,
+        static_cast<double>(AllocationCount() - start_allocations) /
+            recipients);
+  }
+}
+}  // namespace
+
+int main(int argc, char const* argv[]) {
+  auto request_count = kDefaultRequestCount;
+  if (argc > 1) {
+    request_count = std::stoul(argv[1]);
+  }
+  RunDispatch(request_count);
+  RunReplyEncoding(request_count);
+  RunFanOut();
+  return 0;
+}
@@ -0,0 +1,163 @@
+/*
+ * Copyright 2025 Aethernet Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * Bytes per state and encode/decode time per state of the compact PackStates
+ * encoding compared with the regular reflection based encoding of
+ * std::vector<DeviceState>, on a sampled sensor series, a counter series and
+ * an all devices snapshot.
+ * Usage: smart-home-encoding-bench
+ */
+
+#include <chrono>
+#include <random>
+#include <vector>
+#include <cstdint>
+#include <iostream>
+#include <algorithm>
+#include <string_view>
+
+#include "aether/all.h"
+
+#include "api/types.h"
+#include "packed_states.h"
+
+namespace {
+constexpr std::int64_t kStartTime = 1750000000;
+// encode and decode repeated to measure at least this number of states
+constexpr std::size_t kMeasuredStates = 2000000;
+
+// one sensor read each second, float random walk like FakeTempSensor
+std::vector<ae::DeviceState> SensorSeries(std::size_t count) {
+  auto rng = std::mt19937{1};
+  auto step = std::uniform_real_distribution<float>{-2.F, 2.F};
+  auto value = 18.F;
+  std::vector<ae::DeviceState> states;
+  states.reserve(count);
+  for (std::size_t i = 0; i < count; ++i) {
+    value += step(rng);
+    states.push_back(ae::DeviceState{
+        0, ae::DeviceStateData{ae::VariantData{ae::VariantDouble{value}},
+                               kStartTime + static_cast<std::int64_t>(i)}});
+  }
+  return states;
+}
+
+// energy meter counter read each 10 seconds
+std::vector<ae::DeviceState> CounterSeries(std::size_t count) {
+  auto rng = std::mt19937{2};
+  auto step = std::uniform_int_distribution<std::uint64_t>{0, 50};
+  std::uint64_t value = 1000000;
+  std::vector<ae::DeviceState> states;
+  states.reserve(count);
+  for (std::size_t i = 0; i < count; ++i) {
+    value += step(rng);
+    states.push_back(ae::DeviceState{
+        1, ae::DeviceStateData{
+               ae::VariantData{ae::VariantLong{value}},
+               kStartTime + static_cast<std::int64_t>(i) * 10}});
+  }
+  return states;
+}
+
+// the latest state of each device, read at about the same time
+std::vector<ae::DeviceState> Snapshot(std::size_t count) {
+  auto rng = std::mt19937{3};
+  auto temperature = std::uniform_real_distribution<float>{15.F, 30.F};
+  auto age = std::uniform_int_distribution<std::int64_t>{0, 2};
+  std::vector<ae::DeviceState> states;
+  states.reserve(count);
+  for (std::size_t i = 0; i < count; ++i) {
+    states.push_back(ae::DeviceState{
+        static_cast<int>(i),
+        ae::DeviceStateData{
+            ae::VariantData{ae::VariantDouble{temperature(rng)}},
+            kStartTime - age(rng)}});
+  }
+  return states;
+}
+
+ae::DataBuffer ReflectionEncode(std::vector<ae::DeviceState> const& states) {
+  ae::DataBuffer buffer;
+  auto writer = ae::VectorWriter<>{buffer};
+  auto os = ae::omstream{writer};
+  os << states;
+  return buffer;
+}
+
+std::vector<ae::DeviceState> ReflectionDecode(ae::DataBuffer const& buffer) {
+  auto reader = ae::VectorReader<>{buffer};
+  auto is = ae::imstream{reader};
+  std::vector<ae::DeviceState> states;
+  is >> states;
+  return states;
+}
+
+// run func repeat times, return ns per state
+template <typename Func>
+double NsPerState(std::size_t repeat, std::size_t state_count, Func&& func) {
+  auto start_time = std::chrono::steady_clock::now();
+  for (std::size_t i = 0; i < repeat; ++i) {
+    func();
+  }
+  auto elapsed = std::chrono::duration<double, std::nano>{
+      std::chrono::steady_clock::now() - start_time};
+  return elapsed.count() / static_cast<double>(repeat * state_count);
+}
+
+void Compare(std::string_view name,
+             std::vector<ae::DeviceState> const& states) {
+  auto repeat = std::max(kMeasuredStates / states.size(), std::size_t{1});
+  auto count = static_cast<double>(states.size());
+  // keeps the results alive, so the calls are not optimized out
+  std::size_t check_sum = 0;
+
+  auto reflection = ReflectionEncode(states);
+  auto reflection_encode = NsPerState(repeat, states.size(), [&]() {
+    check_sum += ReflectionEncode(states).size();
+  });
+  auto reflection_decode = NsPerState(repeat, states.size(), [&]() {
+    check_sum += ReflectionDecode(reflection).size();
+  });
+
+  auto packed = ae::PackStates(states);
+  auto packed_encode = NsPerState(repeat, states.size(), [&]() {
+    check_sum += ae::PackStates(states).size();
+  });
+  auto packed_decode = NsPerState(repeat, states.size(), [&]() {
+    check_sum += ae::UnpackStates(packed)->size();
+  });
+
+  std::cout << ae::Format("{} ({} states, check {})\n", name, states.size(),
+                          check_sum);
+  std::cout << ae::Format("  {:>10} {:>12.2f} {:>12.1f} {:>12.1f}\n",
+                          "reflection",
+                          static_cast<double>(reflection.size()) / count,
+                          reflection_encode, reflection_decode);
+  std::cout << ae::Format("  {:>10} {:>12.2f} {:>12.1f} {:>12.1f}\n",
+                          "packed", static_cast<double>(packed.size()) / count,
+                          packed_encode, packed_decode);
+}
+}  // namespace
+
+int main() {
+  std::cout << ae::Format("  {:>10} {:>12} {:>12} {:>12}\n", "encoding",
+                          "B/state", "encode ns", "decode ns");
+  Compare("Sensor series, 1 s period", SensorSeries(10000));
+  Compare("Counter series, 10 s period", CounterSeries(10000));
+  Compare("Snapshot of all devices", Snapshot(1000));
+  return 0;
+}
@@ -0,0 +1,48 @@
+/*
+ * Copyright 2025 Aethernet Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "bench/fake_stream.h"
+
+namespace ae {
+FakeStream::FakeStream(ActionContext action_context)
+    // the same action is returned for each write, so writing does not allocate
+    : write_action_{ActionPtr<FailedStreamWriteAction>{action_context}} {}
+
+ActionPtr<StreamWriteAction> FakeStream::Write(DataBuffer&& data) {
+  ++write_count_;
+  written_bytes_ += data.size();
+  return write_action_;
+}
+
+StreamInfo FakeStream::stream_info() const {
+  auto info = StreamInfo{};
+  info.link_state = LinkState::kLinked;
+  info.is_writable = true;
+  return info;
+}
+
+FakeStream::StreamUpdateEvent::Subscriber FakeStream::stream_update_event() {
+  return EventSubscriber{stream_update_event_};
+}
+
+FakeStream::OutDataEvent::Subscriber FakeStream::out_data_event() {
+  return EventSubscriber{out_data_event_};
+}
+
+void FakeStream::Restream() {}
+
+void FakeStream::Receive(DataBuffer const& data) { out_data_event_.Emit(data); }
+}  // namespace ae
@@ -0,0 +1,55 @@
+/*
+ * Copyright 2025 Aethernet Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef BENCH_FAKE_STREAM_H_
+#define BENCH_FAKE_STREAM_H_
+
+#include <cstddef>
+#include <cstdint>
+
+#include "aether/all.h"
+
+namespace ae {
+/**
+ * \brief In-process stream standing in for a client's P2pStream.
+ * Receive delivers a message as if it came from the client, written data is
+ * only counted and dropped.
+ */
+class FakeStream final : public ByteIStream {
+ public:
+  explicit FakeStream(ActionContext action_context);
+
+  ActionPtr<StreamWriteAction> Write(DataBuffer&& data) override;
+  StreamInfo stream_info() const override;
+  StreamUpdateEvent::Subscriber stream_update_event() override;
+  OutDataEvent::Subscriber out_data_event() override;
+  void Restream() override;
+
+  void Receive(DataBuffer const& data);
+
+  std::uint64_t write_count() const { return write_count_; }
+  std::uint64_t written_bytes() const { return written_bytes_; }
+
+ private:
+  ActionPtr<StreamWriteAction> write_action_;
+  StreamUpdateEvent stream_update_event_;
+  OutDataEvent out_data_event_;
+  std::uint64_t write_count_{};
+  std::uint64_t written_bytes_{};
+};
+}  // namespace ae
+
+#endif  // BENCH_FAKE_STREAM_H_
@@ -0,0 +1,120 @@
+/*
+ * Copyright 2025 Aethernet Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * Cost of adding a sample to DeviceHistory and of a day chart query, with a
+ * boot relative clock starting at 0, as before the SNTP sync, and with the
+ * wall clock. Each query is checked against the samples added, the benchmark
+ * fails if a query misses any of them.
+ * Usage: smart-home-history-bench
+ */
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <algorithm>
+#include <string_view>
+
+#include "aether/all.h"
+
+#include "device_history.h"
+
+namespace {
+// one sample each 10 seconds for a week
+constexpr std::int64_t kSampleInterval = 10;
+constexpr std::int64_t kRunTime = 7 * 24 * 3600;
+constexpr std::int64_t kDay = 24 * 3600;
+
+struct Clock {
+  std::string_view name;
+  std::int64_t start_time;
+};
+
+// check the day chart ending at current_time holds all the samples added in
+// the day, the buckets may start before it and hold some more
+bool CheckQuery(ae::DeviceHistory const& history, std::int64_t start_time,
+                std::int64_t current_time, double& query_ns) {
+  auto from = current_time - kDay;
+  auto begin = std::chrono::steady_clock::now();
+  auto buckets = history.Query(from, current_time + 1, 900);
+  query_ns += std::chrono::duration<double, std::nano>{
+      std::chrono::steady_clock::now() - begin}
+                  .count();
+
+  std::int64_t count = 0;
+  for (auto const& bucket : buckets) {
+    count += bucket.count;
+  }
+  auto first = std::max(from, start_time);
+  auto expected = (current_time - start_time) / kSampleInterval -
+                  (first - start_time + kSampleInterval - 1) / kSampleInterval +
+                  1;
+  auto added = (current_time - start_time) / kSampleInterval + 1;
+  return (count >= expected) && (count <= added);
+}
+
+bool Run(Clock const& clock) {
+  auto history = ae::DeviceHistory{};
+  double add_ns = 0;
+  double query_ns = 0;
+  std::size_t sample_count = 0;
+  std::size_t query_count = 0;
+  bool ok = true;
+  for (auto time = clock.start_time; time < clock.start_time + kRunTime;
+       time += kSampleInterval) {
+    auto begin = std::chrono::steady_clock::now();
+    history.Add(time, 20.0 + static_cast<double>(sample_count % 100) / 10.0);
+    add_ns += std::chrono::duration<double, std::nano>{
+        std::chrono::steady_clock::now() - begin}
+                  .count();
+    ++sample_count;
+    // a chart each 10 minutes, and each sample in the first hour when the
+    // ring's reach goes before the clock's start
+    if (((time - clock.start_time) < 3600) ||
+        ((time - clock.start_time) % 600 == 0)) {
+      ++query_count;
+      if (!CheckQuery(history, clock.start_time, time, query_ns)) {
+        std::cerr << ae::Format("{} clock: day chart at {} misses samples\n",
+                                clock.name, time);
+        ok = false;
+        break;
+      }
+    }
+  }
+  std::cout << ae::Format("{:>12} {:>12.1f} {:>14.1f} {:>8}\n", clock.name,
+                          add_ns / static_cast<double>(sample_count),
+                          query_ns / static_cast<double>(query_count),
+                          ok ? "ok" : "FAILED");
+  return ok;
+}
+}  // namespace
+
+int main() {
+  auto clocks = std::array{
+      Clock{"boot", 0},
+      Clock{"wall", 1750000000},
+  };
+  std::cout << ae::Format("History benchmark: a sample each {} s for {} s\n",
+                          kSampleInterval, kRunTime);
+  std::cout << ae::Format("{:>12} {:>12} {:>14} {:>8}\n", "clock", "add ns",
+                          "day query ns", "check");
+  bool ok = true;
+  for (auto const& clock : clocks) {
+    ok = Run(clock) && ok;
+  }
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,158 @@
+/*
+ * Copyright 2025 Aethernet Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * Latency of the network requests while a slow sensor is read.
+ * A commutator has a fast fake sensor and a simulated sensor taking 200 ms
+ * per blocking read, sampled each 250 ms. Requests for the fast sensor arrive
+ * through a fake stream each 10 ms and the time until their replies are
+ * written is measured, first with the slow reads run inline on the loop, then
+ * with the reads run on DeviceIoExecutor workers. Fails if the p99 latency
+ * with the executor is above a few request intervals.
+ * Usage: smart-home-io-bench [seconds]
+ */
+
+#include <deque>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+#include <cstddef>
+#include <iostream>
+#include <algorithm>
+#include <string_view>
+
+#include "aether/all.h"
+
+#include "commutator.h"
+#include "farm/device_farm.h"
+#include "bench/fake_stream.h"
+#include "device_io_executor.h"
+#include "bench/commutator_requests.h"
+#include "temperature/temperature_factory.h"
+
+namespace {
+constexpr auto kClientUid =
+    ae::Uid::FromString("b6a9c0f4-3a7e-4c1e-9d59-2f0d7b4c8e11");
+constexpr std::size_t kDefaultSeconds = 3;
+constexpr auto kSlowReadTime = std::chrono::milliseconds{200};
+constexpr auto kSlowSamplingPeriod = std::chrono::milliseconds{250};
+constexpr auto kRequestInterval = std::chrono::milliseconds{10};
+// p99 latency allowed with the executor, far below the blocking read time
+constexpr auto kMaxExecutorP99 = 5 * kRequestInterval;
+
+using Milliseconds = std::chrono::duration<double, std::milli>;
+
+// returns the p99 latency in ms
+double RunLatency(std::string_view name, std::size_t worker_count,
+                  std::chrono::seconds run_time) {
+  auto action_processor = ae::ActionProcessor{};
+  auto action_context = ae::ActionContext{action_processor};
+  auto io_executor = ae::DeviceIoExecutor{worker_count};
+  auto commutator = ae::Commutator{action_context};
+
+  auto temp_sensor_config =
+      ae::TempSensorConfig{ae::TempSensorType::kFakeTempSensor};
+  auto fast_id = commutator.AddDevice(ae::TemperatureFactory::CreateDevice(
+      action_context, io_executor, &temp_sensor_config));
+  auto farm_config = ae::DeviceFarmConfig{};
+  farm_config.sensor_count = 1;
+  farm_config.latency = kSlowReadTime;
+  farm_config.blocking = true;
+  for (auto& device :
+       ae::CreateDeviceFarm(action_context, io_executor, farm_config)) {
+    commutator.SetSamplingPeriod(commutator.AddDevice(std::move(device)),
+                                 kSlowSamplingPeriod);
+  }
+
+  auto stream = ae::FakeStream{action_context};
+  commutator.AddStream(kClientUid, stream);
+  auto protocol_context = ae::ProtocolContext{};
+  auto request_api = ae::CommutatorRequestApi{protocol_context};
+  auto api_context = ae::ApiContext{request_api};
+  api_context->query_state(static_cast<int>(fast_id));
+  auto request = ae::DataBuffer{std::move(api_context)};
+
+  // arrival times of the requests not answered yet
+  std::deque<ae::TimePoint> pending;
+  std::vector<double> latencies;
+  auto start_time = ae::Now();
+  auto end_time = start_time + run_time;
+  auto next_request_time = start_time;
+  auto replies = stream.write_count();
+  while (true) {
+    auto current_time = ae::Now();
+    if (current_time >= end_time) {
+      break;
+    }
+    // the requests which arrived while the loop was busy are delivered now
+    while (next_request_time <= current_time) {
+      pending.push_back(next_request_time);
+      stream.Receive(request);
+      next_request_time += kRequestInterval;
+    }
+    auto next_time = io_executor.Update(current_time);
+    next_time = std::min(next_time, commutator.Update(current_time));
+    next_time = std::min(next_time, action_processor.Update(current_time));
+
+    auto reply_time = ae::Now();
+    for (; replies < stream.write_count() && !pending.empty(); ++replies) {
+      latencies.push_back(
+          Milliseconds{reply_time - pending.front()}.count());
+      pending.pop_front();
+    }
+    std::this_thread::sleep_until(std::min(next_time, next_request_time));
+  }
+
+  std::sort(std::begin(latencies), std::end(latencies));
+  auto percentile = [&](double part) {
+    if (latencies.empty()) {
+      return 0.0;
+    }
+    auto index = static_cast<std::size_t>(
+        part * static_cast<double>(latencies.size() - 1));
+    return latencies[index];
+  };
+  std::cout << ae::Format("{:>10} {:>8} {:>10.2f} {:>10.2f} {:>10.2f}\n", name,
+                          latencies.size(), percentile(0.5),
+                          percentile(0.99), percentile(1.0));
+  return percentile(0.99);
+}
+}  // namespace
+
+int main(int argc, char const* argv[]) {
+  auto seconds = kDefaultSeconds;
+  if (argc > 1) {
+    seconds = std::stoul(argv[1]);
+  }
+  auto run_time = std::chrono::seconds{seconds};
+  std::cout << ae::Format(
+      "Request latency with a {} ms blocking sensor read, ms\n",
+      kSlowReadTime.count());
+  std::cout << ae::Format("{:>10} {:>8} {:>10} {:>10} {:>10}\n", "reads",
+                          "requests", "p50", "p99", "max");
+  RunLatency("inline", 0, run_time);
+  auto executor_p99 = RunLatency(
+      "executor", ae::DeviceIoExecutor::kDefaultWorkerCount, run_time);
+  auto max_p99 = Milliseconds{kMaxExecutorP99}.count();
+  if (executor_p99 > max_p99) {
+    std::cout << ae::Format("FAIL: executor p99 {:.2f} ms is above {:.0f} ms\n",
+                            executor_p99, max_p99);
+    return 1;
+  }
+  std::cout << ae::Format("OK: executor p99 is within {:.0f} ms\n", max_p99);
+  return 0;
+}
@@ -0,0 +1,203 @@
+/*
+ * Copyright 2025 Aethernet Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * Soak of the commutator's stream table with client churn.
+ * A commutator with one fake sensor and a table of 256 streams serves 100
+ * subscribers for the whole run, while each cycle 10000 transient clients
+ * connect through fake streams and send one query. Every other one
+ * disconnects right after the answer, the others are evicted by the newer
+ * clients or expire after the idle timeout, then all of the cycle's streams
+ * are released. The application loop runs on a simulated clock.
+ * The heap allocations alive after each cycle must stay flat after the first
+ * half of the cycles: any entry, dispatcher or subscription kept for a gone
+ * client shows as growth. Every
+ * subscriber must also get pushes in each cycle, the transient clients are the
+ * ones to make room and to expire, never the subscribers.
+ * Usage: smart-home-soak-bench [clients per cycle]
+ */
+
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <algorithm>
+
+#include "aether/all.h"
+
+#include "alloc_counter.h"
+
+#include "commutator.h"
+#include "device_io_executor.h"
+#include "bench/fake_stream.h"
+#include "bench/commutator_requests.h"
+#include "temperature/temperature_factory.h"
+
+namespace {
+constexpr std::size_t kDefaultClientCount = 10000;
+constexpr std::size_t kSubscriberCount = 100;
+constexpr std::size_t kTableSize = 256;
+constexpr std::size_t kCycleCount = 20;
+// transient clients connected per application loop step
+constexpr std::size_t kClientsPerStep = 100;
+constexpr auto kIdleTimeout = std::chrono::minutes{1};
+constexpr auto kStep = std::chrono::seconds{1};
+
+ae::Uid ClientUid(std::size_t index) {
+  return ae::Uid::FromString(
+      ae::Format("00000000-0000-4000-8000-{:012x}", index + 1));
+}
+
+template <typename Encode>
+ae::DataBuffer EncodeRequest(ae::ProtocolContext& protocol_context,
+                             Encode&& encode) {
+  auto request_api = ae::CommutatorRequestApi{protocol_context};
+  auto api_context = ae::ApiContext{request_api};
+  encode(api_context);
+  return std::move(api_context);
+}
+
+struct FakeClient {
+  ae::Uid uid;
+  std::unique_ptr<ae::FakeStream> stream;
+};
+}  // namespace
+
+int main(int argc, char const* argv[]) {
+  auto client_count = kDefaultClientCount;
+  if (argc > 1) {
+    client_count = std::stoul(argv[1]);
+  }
+
+  auto action_processor = ae::ActionProcessor{};
+  auto action_context = ae::ActionContext{action_processor};
+  // the subscribers' streams must outlive the commutator
+  std::vector<FakeClient> subscribers;
+  subscribers.reserve(kSubscriberCount);
+
+  auto config = ae::CommutatorConfig{};
+  config.max_stream_count = kTableSize;
+  config.stream_idle_timeout = kIdleTimeout;
+  auto commutator = ae::Commutator{action_context, config};
+  auto io_executor = ae::DeviceIoExecutor{0};
+  auto temp_sensor_config =
+      ae::TempSensorConfig{ae::TempSensorType::kFakeTempSensor};
+  commutator.AddDevice(ae::TemperatureFactory::CreateDevice(
+      action_context, io_executor, &temp_sensor_config));
+
+  auto protocol_context = ae::ProtocolContext{};
+  // each subscriber gets a push on each loop step
+  auto subscribe = EncodeRequest(protocol_context, [](auto& api) {
+    api->subscribe_state(0, 0, -1.0);
+  });
+  auto query = EncodeRequest(protocol_context,
+                             [](auto& api) { api->query_state(0); });
+
+  auto current_time = ae::Now();
+  auto step = [&]() {
+    current_time += kStep;
+    commutator.Update(current_time);
+    action_processor.Update(current_time);
+  };
+
+  for (std::size_t i = 0; i < kSubscriberCount; ++i) {
+    auto& subscriber = subscribers.emplace_back(FakeClient{
+        ClientUid(i), std::make_unique<ae::FakeStream>(action_context)});
+    commutator.AddStream(subscriber.uid, *subscriber.stream);
+    subscriber.stream->Receive(subscribe);
+  }
+  step();
+
+  std::cout << ae::Format(
+      "Soak benchmark: {} subscribers, {} cycles of {} transient clients, {} "
+      "streams table, idle timeout {} s\n",
+      kSubscriberCount, kCycleCount, client_count, kTableSize,
+      std::chrono::duration_cast<std::chrono::seconds>(kIdleTimeout).count());
+  std::cout << ae::Format("{:>6} {:>12} {:>16} {:>10}\n", "cycle", "clients",
+                          "live allocs", "lost subs");
+
+  auto start_time = std::chrono::steady_clock::now();
+  std::vector<FakeClient> transients;
+  transients.reserve(client_count);
+  std::vector<std::uint64_t> write_counts(kSubscriberCount);
+  std::vector<std::uint64_t> live_allocations;
+  std::size_t lost_count = 0;
+  auto next_uid = kSubscriberCount;
+  for (std::size_t cycle = 0; cycle < kCycleCount; ++cycle) {
+    for (std::size_t i = 0; i < kSubscriberCount; ++i) {
+      write_counts[i] = subscribers[i].stream->write_count();
+    }
+
+    for (std::size_t i = 0; i < client_count; ++i) {
+      auto& client = transients.emplace_back(FakeClient{
+          ClientUid(next_uid++),
+          std::make_unique<ae::FakeStream>(action_context)});
+      commutator.AddStream(client.uid, *client.stream);
+      client.stream->Receive(query);
+      if (((i + 1) % kClientsPerStep) == 0) {
+        step();
+        // every other client of the step disconnects after its answer
+        for (auto j = transients.size() - kClientsPerStep;
+             j < transients.size(); j += 2) {
+          commutator.RemoveStream(transients[j].uid);
+        }
+      }
+    }
+    // the clients still in the table expire
+    for (auto idle = kStep; idle <= kIdleTimeout + kStep; idle += kStep) {
+      step();
+    }
+    for (auto& client : transients) {
+      commutator.RemoveStream(client.uid);
+    }
+    transients.clear();
+
+    std::size_t cycle_lost = 0;
+    for (std::size_t i = 0; i < kSubscriberCount; ++i) {
+      if (subscribers[i].stream->write_count() == write_counts[i]) {
+        ++cycle_lost;
+      }
+    }
+    lost_count += cycle_lost;
+    live_allocations.push_back(LiveAllocationCount());
+    std::cout << ae::Format("{:>6} {:>12} {:>16} {:>10}\n", cycle,
+                            next_uid - kSubscriberCount,
+                            live_allocations.back(), cycle_lost);
+  }
+  auto elapsed = std::chrono::duration<double>{
+      std::chrono::steady_clock::now() - start_time};
+
+  // the first half of the cycles fill the pools and the capacities, the live
+  // allocations must not grow after it
+  auto warm = *std::max_element(
+      std::begin(live_allocations),
+      std::begin(live_allocations) +
+          static_cast<std::ptrdiff_t>(live_allocations.size() / 2));
+  auto growth = (live_allocations.back() > warm)
+                    ? (live_allocations.back() - warm)
+                    : std::uint64_t{0};
+  // a capacity reached late may still add a few, anything leaked for the gone
+  // clients grows with the clients of each cycle
+  auto allowed_growth = static_cast<std::uint64_t>(client_count / 100);
+  std::cout << ae::Format(
+      "{:.1f} s, live allocations grew by {} after the warm-up, {} subscriber "
+      "pushes missed\n",
+      elapsed.count(), growth, lost_count);
+  return ((growth <= allowed_growth) && (lost_count == 0)) ? 0 : 1;
+}
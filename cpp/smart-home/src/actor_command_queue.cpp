@@ -0,0 +1,171 @@
+/*
+ * Copyright 2025 Aethernet Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "actor_command_queue.h"
+
+#include <utility>
+#include <iterator>
+#include <algorithm>
+
+namespace ae {
+namespace {
+// how long Update may sleep without delayed commands
+constexpr auto kIdleUpdateInterval = std::chrono::seconds{60};
+}  // namespace
+
+ActorCommandQueue::ActorCommandQueue(DeviceRegistry const& devices,
+                                     Duration min_interval,
+                                     DoneCallback on_done)
+    : devices_{&devices},
+      default_min_interval_{min_interval},
+      on_done_{std::move(on_done)} {}
+
+void ActorCommandQueue::Push(std::size_t local_id, VariantData command,
+                             CommandPriority priority, Requester requester) {
+  auto& queue = actor(local_id);
+  auto new_command = Command{std::move(command), priority, {}};
+  // pending priorities decrease, so the superseded commands are the tail
+  auto superseded = std::find_if(
+      std::begin(queue.pending), std::end(queue.pending),
+      [&](auto const& pending) { return pending.priority <= priority; });
+  for (auto it = superseded; it != std::end(queue.pending); ++it) {
+    ++coalesced_count_;
+    new_command.requesters.insert(
+        std::end(new_command.requesters),
+        std::make_move_iterator(std::begin(it->requesters)),
+        std::make_move_iterator(std::end(it->requesters)));
+  }
+  queue.pending.erase(superseded, std::end(queue.pending));
+  new_command.requesters.push_back(std::move(requester));
+  queue.pending.push_back(std::move(new_command));
+
+  if (!queue.waiting) {
+    queue.waiting = true;
+    waiting_.push_back(local_id);
+  }
+  TryRun(local_id, queue, Now());
+}
+
+void ActorCommandQueue::SetMinInterval(std::size_t local_id,
+                                       Duration min_interval) {
+  actor(local_id).min_interval = min_interval;
+}
+
+void ActorCommandQueue::Remove(std::size_t local_id) {
+  auto* queue = FindActor(local_id);
+  if (queue == nullptr) {
+    return;
+  }
+  auto requesters = std::move(queue->running);
+  for (auto& pending : queue->pending) {
+    requesters.insert(std::end(requesters),
+                      std::make_move_iterator(std::begin(pending.requesters)),
+                      std::make_move_iterator(std::end(pending.requesters)));
+  }
+  // ids are not reused, a late result of the running command is dropped
+  actors_[local_id].reset();
+  if (!requesters.empty()) {
+    on_done_(local_id, requesters, nullptr);
+  }
+}
+
+TimePoint ActorCommandQueue::Update(TimePoint current_time) {
+  auto next_time = current_time + kIdleUpdateInterval;
+  for (std::size_t i = 0; i < waiting_.size();) {
+    auto local_id = waiting_[i];
+    auto* queue = FindActor(local_id);
+    if ((queue == nullptr) || queue->pending.empty()) {
+      if (queue != nullptr) {
+        queue->waiting = false;
+      }
+      waiting_[i] = waiting_.back();
+      waiting_.pop_back();
+      continue;
+    }
+    TryRun(local_id, *queue, current_time);
+    // the queue of an actor found removed is dropped by TryRun
+    queue = FindActor(local_id);
+    // a running command calls TryRun itself when done
+    if ((queue != nullptr) && !queue->executing && !queue->pending.empty()) {
+      next_time = std::min(next_time, queue->next_time);
+    }
+    ++i;
+  }
+  return next_time;
+}
+
+ActorCommandQueue::Actor& ActorCommandQueue::actor(std::size_t local_id) {
+  if (local_id >= actors_.size()) {
+    actors_.resize(local_id + 1);
+  }
+  auto& queue = actors_[local_id];
+  if (!queue) {
+    queue = std::make_unique<Actor>(
+        Actor{default_min_interval_, TimePoint{}, false, false, {}, {}});
+  }
+  return *queue;
+}
+
+ActorCommandQueue::Actor* ActorCommandQueue::FindActor(std::size_t local_id) {
+  return (local_id < actors_.size()) ? actors_[local_id].get() : nullptr;
+}
+
+void ActorCommandQueue::TryRun(std::size_t local_id, Actor& queue,
+                               TimePoint current_time) {
+  if (queue.executing || queue.pending.empty()) {
+    return;
+  }
+  auto& command = queue.pending.front();
+  if ((command.priority != CommandPriority::kSafety) &&
+      (current_time < queue.next_time)) {
+    return;
+  }
+  auto* device = devices_->Find(local_id);
+  if (device == nullptr) {
+    Remove(local_id);
+    return;
+  }
+  queue.executing = true;
+  queue.next_time = current_time + queue.min_interval;
+  queue.running = std::move(command.requesters);
+  auto state_action = device->Execute(command.command);
+  queue.pending.erase(std::begin(queue.pending));
+
+  state_action->StatusEvent().Subscribe(ActionHandler{
+      OnResult{[this, local_id](auto const& action) {
+        auto state = action.state_data();
+        Done(local_id, &state);
+      }},
+      OnError{[this, local_id]() { Done(local_id, nullptr); }},
+  });
+}
+
+void ActorCommandQueue::Done(std::size_t local_id,
+                             DeviceStateData const* state) {
+  auto* queue = FindActor(local_id);
+  if (queue == nullptr) {
+    return;
+  }
+  queue->executing = false;
+  auto requesters = std::move(queue->running);
+  queue->running.clear();
+  on_done_(local_id, requesters, state);
+  // a safety command does not wait for the next update
+  if (auto* next_queue = FindActor(local_id); next_queue != nullptr) {
+    TryRun(local_id, *next_queue, Now());
+  }
+}
+}  // namespace ae
@@ -0,0 +1,126 @@
+/*
+ * Copyright 2025 Aethernet Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ACTOR_COMMAND_QUEUE_H_
+#define ACTOR_COMMAND_QUEUE_H_
+
+#include <memory>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+
+#include "aether/all.h"
+
+#include "idevice.h"
+#include "api/types.h"
+#include "device_registry.h"
+
+namespace ae {
+enum class CommandPriority : std::uint8_t {
+  kNormal = 0,
+  kHigh = 1,
+  // not delayed by the rate limit
+  kSafety = 2,
+};
+
+/**
+ * \brief Per actor queue of commands.
+ * An actor runs one command at a time and not more often than its minimal
+ * interval, except the safety commands. A new command supersedes the pending
+ * commands of the same or lower priority (the last writer wins), and the
+ * requests of the superseded commands are answered with its result. So an
+ * actor toggled by many clients at once is driven only with the last state
+ * requested, and a pending safety command is never overwritten by a less
+ * important one.
+ */
+class ActorCommandQueue {
+ public:
+  struct Requester {
+    Uid client_uid;
+    RequestId request_id;
+    // for the request metrics
+    std::uint8_t method_id;
+    TimePoint request_time;
+  };
+  /**
+   * \brief Called when a command is done, state is nullptr if it failed.
+   */
+  using DoneCallback =
+      std::function<void(std::size_t local_id,
+                         std::vector<Requester> const& requesters,
+                         DeviceStateData const* state)>;
+
+  ActorCommandQueue(DeviceRegistry const& devices, Duration min_interval,
+                    DoneCallback on_done);
+
+  void Push(std::size_t local_id, VariantData command,
+            CommandPriority priority, Requester requester);
+  /**
+   * \brief Set the minimal interval between the actor's commands.
+   */
+  void SetMinInterval(std::size_t local_id, Duration min_interval);
+  /**
+   * \brief Drop the removed actor's queue, its pending commands fail.
+   */
+  void Remove(std::size_t local_id);
+
+  /**
+   * \brief Run the commands delayed by the rate limit.
+   * Must be called on each application loop iteration.
+   * Returns the time it should be called next.
+   */
+  TimePoint Update(TimePoint current_time);
+
+  std::uint64_t coalesced_count() const { return coalesced_count_; }
+
+ private:
+  struct Command {
+    VariantData command;
+    CommandPriority priority;
+    std::vector<Requester> requesters;
+  };
+  struct Actor {
+    Duration min_interval;
+    TimePoint next_time;
+    bool executing;
+    bool waiting;
+    // requesters of the running command
+    std::vector<Requester> running;
+    // in arrival order and so in decreasing priority, one per priority at most
+    std::vector<Command> pending;
+  };
+
+  Actor& actor(std::size_t local_id);
+  Actor* FindActor(std::size_t local_id);
+  /**
+   * \brief Run the first pending command if the actor is ready for it.
+   */
+  void TryRun(std::size_t local_id, Actor& actor, TimePoint current_time);
+  void Done(std::size_t local_id, DeviceStateData const* state);
+
+  DeviceRegistry const* devices_;
+  Duration default_min_interval_;
+  DoneCallback on_done_;
+  // indexed by local id, empty for the actors never commanded
+  std::vector<std::unique_ptr<Actor>> actors_;
+  // actors with pending commands
+  std::vector<std::size_t> waiting_;
+  std::uint64_t coalesced_count_{};
+};
+}  // namespace ae
+
+#endif  // ACTOR_COMMAND_QUEUE_H_
@@ -18,6 +18,9 @@
 
 namespace ae {
 SmartHomeClientApi::SmartHomeClientApi(ProtocolContext& protocol_context)
-    : ApiClass{protocol_context}, device_state_updated{protocol_context} {}
+    : ApiClass{protocol_context},
+      device_state_updated{protocol_context},
+      device_states_updated{protocol_context},
+      device_states_packed{protocol_context} {}
 
 }  // namespace ae
@@ -24,6 +24,20 @@
 namespace ae {
 class SmartHomeCommutatorApi : public ApiClassImpl<SmartHomeCommutatorApi> {
  public:
+  // ids the methods are registered with, also reported in the metrics
+  static constexpr std::uint8_t kExecuteActorCommandId = 4;
+  static constexpr std::uint8_t kQueryStateId = 5;
+  static constexpr std::uint8_t kQueryAllSensorStatesId = 6;
+  static constexpr std::uint8_t kQueryAllSensorStatesBatchId = 7;
+  static constexpr std::uint8_t kSubscribeStateId = 8;
+  static constexpr std::uint8_t kUnsubscribeStateId = 9;
+  static constexpr std::uint8_t kGetSystemStructureId = 10;
+  static constexpr std::uint8_t kGetStructureVersionId = 11;
+  static constexpr std::uint8_t kQueryHistoryId = 12;
+  static constexpr std::uint8_t kQueryAllSensorStatesPackedId = 13;
+  static constexpr std::uint8_t kExecuteActorCommandWithPriorityId = 14;
+  static constexpr std::uint8_t kGetMetricsId = 15;
+
   using ApiClassImpl::ApiClassImpl;
 
   virtual ~SmartHomeCommutatorApi() = default;
@@ -33,14 +47,80 @@ class SmartHomeCommutatorApi : public ApiClassImpl<SmartHomeCommutatorApi> {
 
   virtual void ExecuteActorCommand(PromiseResult<DeviceStateData> result,
                                    int local_actor_id, VariantData command) = 0;
+  /**
+   * \brief Same as ExecuteActorCommand, which runs with the normal priority 0.
+   * A command supersedes the actor's pending commands of the same or lower
+   * priority and its result answers their requests too. Priority 2 is for
+   * safety commands, they are not delayed by the actor's rate limit. Other
+   * priorities are rejected with error 5.
+   */
+  virtual void ExecuteActorCommandWithPriority(
+      PromiseResult<DeviceStateData> result, int local_actor_id,
+      VariantData command, std::uint8_t priority) = 0;
   virtual void QueryState(PromiseResult<DeviceStateData> result,
                           int local_device_id) = 0;
+  /**
+   * \brief Version of the system structure, changed on each device added or
+   * removed. Compare it with the version got together with the structure to
+   * know if GetSystemStructure should be requested again.
+   */
+  virtual void GetStructureVersion(PromiseResult<std::uint32_t> result) = 0;
   virtual void QueryAllSensorStates() = 0;
+  /**
+   * \brief Same as QueryAllSensorStates, but all the states are sent in one
+   * device_states_updated message.
+   */
+  virtual void QueryAllSensorStatesBatch() = 0;
+  /**
+   * \brief Same as QueryAllSensorStatesBatch, but the states are sent in the
+   * compact PackStates encoding in one device_states_packed message.
+   */
+  virtual void QueryAllSensorStatesPacked() = 0;
+  /**
+   * \brief Push device_state_updated on device state change.
+   * The state is checked not more often than min_interval_ms and a numeric
+   * value is pushed only if it moved by more than deadband since the last
+   * pushed one. Subscribing again changes the parameters.
+   */
+  virtual void SubscribeState(int local_device_id,
+                              std::uint32_t min_interval_ms,
+                              double deadband) = 0;
+  virtual void UnsubscribeState(int local_device_id) = 0;
+  /**
+   * \brief Aggregated history of a sampled device in [from, to) seconds, in
+   * buckets of resolution seconds or coarser ones if the history keeps no
+   * finer ones for that time.
+   */
+  virtual void QueryHistory(PromiseResult<std::vector<HistoryBucket>> result,
+                            int local_device_id, std::int64_t from,
+                            std::int64_t to, std::uint32_t resolution) = 0;
+  /**
+   * \brief Request counts, latencies and errors per method, and the
+   * commutator's load.
+   */
+  virtual void GetMetrics(PromiseResult<CommutatorMetrics> result) = 0;
 
-  AE_METHODS(RegMethod<10, &SmartHomeCommutatorApi::GetSystemStructure>,
-             RegMethod<4, &SmartHomeCommutatorApi::ExecuteActorCommand>,
-             RegMethod<5, &SmartHomeCommutatorApi::QueryState>,
-             RegMethod<6, &SmartHomeCommutatorApi::QueryAllSensorStates>);
+  AE_METHODS(
+      RegMethod<kGetSystemStructureId,
+                &SmartHomeCommutatorApi::GetSystemStructure>,
+      RegMethod<kExecuteActorCommandId,
+                &SmartHomeCommutatorApi::ExecuteActorCommand>,
+      RegMethod<kQueryStateId, &SmartHomeCommutatorApi::QueryState>,
+      RegMethod<kQueryAllSensorStatesId,
+                &SmartHomeCommutatorApi::QueryAllSensorStates>,
+      RegMethod<kQueryAllSensorStatesBatchId,
+                &SmartHomeCommutatorApi::QueryAllSensorStatesBatch>,
+      RegMethod<kSubscribeStateId, &SmartHomeCommutatorApi::SubscribeState>,
+      RegMethod<kUnsubscribeStateId,
+                &SmartHomeCommutatorApi::UnsubscribeState>,
+      RegMethod<kGetStructureVersionId,
+                &SmartHomeCommutatorApi::GetStructureVersion>,
+      RegMethod<kQueryHistoryId, &SmartHomeCommutatorApi::QueryHistory>,
+      RegMethod<kQueryAllSensorStatesPackedId,
+                &SmartHomeCommutatorApi::QueryAllSensorStatesPacked>,
+      RegMethod<kExecuteActorCommandWithPriorityId,
+                &SmartHomeCommutatorApi::ExecuteActorCommandWithPriority>,
+      RegMethod<kGetMetricsId, &SmartHomeCommutatorApi::GetMetrics>);
 };
 
 class SmartHomeClientApi : public ApiClass {
@@ -49,6 +129,9 @@ class SmartHomeClientApi : public ApiClass {
 
   Method<3, void(int local_device_id, DeviceStateData state)>
       device_state_updated;
+  Method<4, void(std::vector<DeviceState> states)> device_states_updated;
+  // std::vector<DeviceState> encoded by PackStates
+  Method<5, void(DataBuffer packed_states)> device_states_packed;
 };
 
 }  // namespace ae
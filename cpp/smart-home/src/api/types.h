@@ -18,6 +18,7 @@
 #define API_TYPES_H_
 
 #include <string>
+#include <vector>
 #include <cstdint>
 #include <optional>
 
@@ -64,6 +65,28 @@ struct DeviceStateData {
   std::int64_t timestamp;
 };
 
+struct DeviceState {
+  AE_REFLECT_MEMBERS(local_device_id, state)
+
+  int local_device_id;
+  DeviceStateData state;
+};
+
+/**
+ * \brief Aggregate of the numeric device states in [start_time, start_time +
+ * duration) seconds.
+ */
+struct HistoryBucket {
+  AE_REFLECT_MEMBERS(start_time, duration, min, max, avg, count)
+
+  std::int64_t start_time;
+  std::uint32_t duration;
+  double min;
+  double max;
+  double avg;
+  std::uint32_t count;
+};
+
 struct HwDeviceBase {
   AE_REFLECT_MEMBERS(local_id, descriptor)
 
@@ -85,6 +108,44 @@ struct HardwareDevice
                          VPair<2, HardwareActor>> {
   using VariantType::VariantType;
 };
+
+/**
+ * \brief Requests of one API method since the commutator start.
+ * latency_histogram[i] counts the requests answered within
+ * latency_bounds_ms[i] of CommutatorMetrics and not within the previous bound,
+ * the last item counts the slower ones. Latency is measured from the parsing
+ * of the request to its reply sent.
+ */
+struct MethodMetrics {
+  AE_REFLECT_MEMBERS(method_id, count, error_count, latency_sum_us,
+                     max_latency_us, latency_histogram)
+
+  std::uint8_t method_id;
+  std::uint32_t count;
+  std::uint32_t error_count;
+  std::uint64_t latency_sum_us;
+  std::uint32_t max_latency_us;
+  std::vector<std::uint32_t> latency_histogram;
+};
+
+struct CommutatorMetrics {
+  AE_REFLECT_MEMBERS(uptime, in_flight, max_in_flight, latency_bounds_ms,
+                     methods, stream_count, cache_hit_count, cache_miss_count,
+                     coalesced_command_count)
+
+  // seconds since the commutator start
+  std::uint32_t uptime;
+  // requests parsed and not answered yet
+  std::uint32_t in_flight;
+  std::uint32_t max_in_flight;
+  std::vector<std::uint32_t> latency_bounds_ms;
+  // only the methods requested at least once
+  std::vector<MethodMetrics> methods;
+  std::uint32_t stream_count;
+  std::uint64_t cache_hit_count;
+  std::uint64_t cache_miss_count;
+  std::uint64_t coalesced_command_count;
+};
 }  // namespace ae
 
 #endif  // API_TYPES_H_
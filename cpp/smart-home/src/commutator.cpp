@@ -15,48 +15,381 @@
  */
 
 #include "commutator.h"
+
+#include <cmath>
+#include <variant>
+#include <algorithm>
+
+#include "packed_states.h"
 #include "commutator_api_impl.h"
 
 namespace ae {
-Commutator::Commutator(Client::ptr const& client)
-    : client_{client}, client_api_{protocol_context_} {
+namespace {
+// how long Update may sleep without subscriptions
+constexpr auto kIdleUpdateInterval = std::chrono::seconds{60};
+
+// value to compare with the deadband, if the state is a number
+std::optional<double> NumericValue(VariantData const& payload) {
+  if (auto const* value = std::get_if<VariantDouble>(&payload); value) {
+    return value->value;
+  }
+  if (auto const* value = std::get_if<VariantLong>(&payload); value) {
+    return static_cast<double>(value->value);
+  }
+  if (auto const* value = std::get_if<VariantBool>(&payload); value) {
+    return value->value ? 1.0 : 0.0;
+  }
+  return std::nullopt;
+}
+}  // namespace
+
+Commutator::Commutator(ActionContext action_context, Client::ptr const& client,
+                       CommutatorConfig const& config)
+    : Commutator{action_context, config} {
+  client_ = client;
   new_request_sub_ =
       client->message_stream_manager().new_stream_event().Subscribe(
           MethodPtr<&Commutator::OnNewStream>{this});
 }
 
-void Commutator::AddDevice(std::unique_ptr<IDevice>&& device) {
-  assert(device && "Device cannot be null");
-  devices_.push_back(std::move(device));
+Commutator::Commutator(ActionContext action_context,
+                       CommutatorConfig const& config)
+    : client_api_{protocol_context_},
+      state_cache_{action_context, config.state_max_age},
+      sampler_{devices_},
+      commands_{devices_, config.actor_command_interval,
+                [this](auto local_id, auto const& requesters, auto state) {
+                  CommandDone(local_id, requesters, state);
+                }},
+      streams_{config.max_stream_count, config.stream_idle_timeout,
+               [this](Uid const& uid) { UnsubscribeAll(uid); }} {}
+
+std::size_t Commutator::AddDevice(std::unique_ptr<IDevice>&& device) {
+  return devices_.Add(std::move(device));
 }
 
-void Commutator::SendSensorsState(RcPtr<P2pStream> const& stream) {
-  for (std::size_t i = 0; i < devices_.size(); ++i) {
-    auto state_action = devices_[i]->GetState();
-    state_action->StatusEvent().Subscribe(OnResult{[stream, this,
-                                                    i](auto const& action) {
-      auto api_call = ApiCallAdapter{ApiContext{client_api_}, *stream};
-      api_call->device_state_updated(static_cast<int>(i), action.state_data());
-      api_call.Flush();
-    }});
+bool Commutator::RemoveDevice(std::size_t local_id) {
+  if (!devices_.Remove(local_id)) {
+    return false;
+  }
+  std::vector<Uid> subscribers;
+  for (auto const& subscription : subscriptions_) {
+    if (subscription.device_index == local_id) {
+      subscribers.push_back(subscription.subscriber);
+    }
   }
+  subscriptions_.erase(
+      std::remove_if(std::begin(subscriptions_), std::end(subscriptions_),
+                     [&](auto const& subscription) {
+                       return subscription.device_index == local_id;
+                     }),
+      std::end(subscriptions_));
+  // the streams left without subscriptions may become idle again
+  for (auto const& subscriber : subscribers) {
+    UpdateSubscribed(subscriber);
+  }
+  state_cache_.Remove(local_id);
+  sampler_.SetPeriod(local_id, Duration::zero());
+  history_.Remove(local_id);
+  commands_.Remove(local_id);
+  return true;
 }
 
-void Commutator::OnNewStream(RcPtr<P2pStream> stream) {
-  // store the stream inside the subscription
-  streams_[stream->destination()] = stream;
-  new_message_subs_.Push(stream->out_data_event().Subscribe(
-      [stream_view{RcPtrView{stream}}, this](DataBuffer const& data) {
-        if (auto stream = stream_view.lock(); stream) {
-          OnNewMessage(stream, data);
+void Commutator::SetSamplingPeriod(std::size_t local_id, Duration period) {
+  if (devices_.Find(local_id) == nullptr) {
+    return;
+  }
+  sampler_.SetPeriod(local_id, period);
+  state_cache_.SetSampled(local_id, period != Duration::zero());
+}
+
+void Commutator::SetCommandInterval(std::size_t local_id, Duration interval) {
+  if (devices_.Find(local_id) == nullptr) {
+    return;
+  }
+  commands_.SetMinInterval(local_id, interval);
+}
+
+void Commutator::AddStream(Uid const& client_uid, ByteIStream& stream) {
+  ServeStream(client_uid, stream, {});
+}
+
+void Commutator::RemoveStream(Uid const& client_uid) {
+  streams_.Remove(client_uid);
+}
+
+TimePoint Commutator::Update(TimePoint current_time) {
+  sampler_.Drain([this](std::size_t local_id, DeviceStateData&& state) {
+    if (auto value = NumericValue(state.payload); value) {
+      history_.Add(local_id, state.timestamp, *value);
+    }
+    state_cache_.Store(local_id, std::move(state));
+  });
+  auto next_time = sampler_.Update(current_time);
+  next_time = std::min(next_time, commands_.Update(current_time));
+  next_time = std::min(next_time, metrics_.Update(current_time));
+  due_devices_.clear();
+  for (auto& subscription : subscriptions_) {
+    if (!subscription.reading &&
+        (subscription.next_check_time <= current_time)) {
+      subscription.next_check_time = current_time + subscription.min_interval;
+      subscription.reading = true;
+      if (std::find(std::begin(due_devices_), std::end(due_devices_),
+                    subscription.device_index) == std::end(due_devices_)) {
+        due_devices_.push_back(subscription.device_index);
+      }
+    }
+    next_time = std::min(next_time, subscription.next_check_time);
+  }
+  for (auto device_index : due_devices_) {
+    CheckSubscribedDevice(device_index);
+  }
+  next_time = std::min(next_time, streams_.RemoveIdle(current_time));
+  next_time = std::min(next_time, current_time + kIdleUpdateInterval);
+  return next_time;
+}
+
+void Commutator::CommandDone(
+    std::size_t local_id,
+    std::vector<ActorCommandQueue::Requester> const& requesters,
+    DeviceStateData const* state) {
+  if ((state != nullptr) && (devices_.Find(local_id) != nullptr)) {
+    // the command result is the newest device state
+    state_cache_.Store(local_id, *state);
+  }
+  for (auto const& requester : requesters) {
+    metrics_.Record(requester.method_id, requester.request_time,
+                    state != nullptr);
+    auto* api_impl = FindApiImpl(requester.client_uid);
+    if (api_impl == nullptr) {
+      continue;
+    }
+    if (state != nullptr) {
+      api_impl->SendResult(requester.request_id, *state);
+    } else {
+      api_impl->SendError(requester.request_id, 4);
+    }
+  }
+}
+
+void Commutator::SendSensorsState(Uid const& client_uid) {
+  devices_.ForEach([&](std::size_t i, IDevice& device) {
+    auto state_action = state_cache_.GetState(i, device);
+    state_action->StatusEvent().Subscribe(
+        OnResult{[this, client_uid, i](auto const& action) {
+          auto* api_impl = FindApiImpl(client_uid);
+          if (api_impl == nullptr) {
+            return;
+          }
+          auto api_call =
+              ApiCallAdapter{ApiContext{client_api_}, api_impl->stream()};
+          api_call->device_state_updated(static_cast<int>(i),
+                                         action.state_data());
+          api_call.Flush();
+        }});
+  });
+}
+
+void Commutator::SendSensorsStateBatch(Uid const& client_uid, bool packed,
+                                       TimePoint request_time) {
+  struct Batch {
+    std::size_t pending_count;
+    std::vector<DeviceState> states;
+  };
+
+  auto batch = std::make_shared<Batch>();
+  batch->pending_count = devices_.size();
+  batch->states.reserve(devices_.size());
+
+  auto state_collected = [this, client_uid, packed, request_time, batch]() {
+    if (--batch->pending_count != 0) {
+      return;
+    }
+    auto method_id = packed
+                         ? SmartHomeCommutatorApi::kQueryAllSensorStatesPackedId
+                         : SmartHomeCommutatorApi::kQueryAllSensorStatesBatchId;
+    auto* api_impl = FindApiImpl(client_uid);
+    if (api_impl == nullptr) {
+      metrics_.Record(method_id, request_time, false);
+      return;
+    }
+    auto api_call =
+        ApiCallAdapter{ApiContext{client_api_}, api_impl->stream()};
+    if (packed) {
+      api_call->device_states_packed(PackStates(batch->states));
+    } else {
+      api_call->device_states_updated(std::move(batch->states));
+    }
+    api_call.Flush();
+    metrics_.Record(method_id, request_time, true);
+  };
+
+  if (devices_.empty()) {
+    // answer with an empty list anyway
+    ++batch->pending_count;
+    state_collected();
+    return;
+  }
+
+  devices_.ForEach([&](std::size_t i, IDevice& device) {
+    auto state_action = state_cache_.GetState(i, device);
+    state_action->StatusEvent().Subscribe(ActionHandler{
+        OnResult{[batch, state_collected, i](auto const& action) {
+          batch->states.push_back(
+              DeviceState{static_cast<int>(i), action.state_data()});
+          state_collected();
+        }},
+        // a failed device is left out of the list
+        OnError{[state_collected]() { state_collected(); }},
+    });
+  });
+}
+
+CommutatorMetrics Commutator::CollectMetrics(TimePoint current_time) const {
+  auto metrics = CommutatorMetrics{};
+  metrics_.Snapshot(current_time, metrics);
+  metrics.stream_count = static_cast<std::uint32_t>(streams_.size());
+  metrics.cache_hit_count = state_cache_.hit_count();
+  metrics.cache_miss_count = state_cache_.miss_count();
+  metrics.coalesced_command_count = commands_.coalesced_count();
+  return metrics;
+}
+
+void Commutator::Subscribe(CommutatorApiImpl& subscriber,
+                           std::size_t device_index, Duration min_interval,
+                           double deadband) {
+  auto* subscription = FindSubscription(subscriber.client_uid(), device_index);
+  if (subscription == nullptr) {
+    subscription = &subscriptions_.emplace_back(
+        StateSubscription{subscriber.client_uid(), &subscriber, device_index,
+                          {}, {}, {}, std::nullopt, false});
+  }
+  streams_.SetSubscribed(subscriber.client_uid(), true, Now());
+  subscription->min_interval = min_interval;
+  subscription->deadband = deadband;
+  // push the current state on the next update
+  subscription->next_check_time = TimePoint{};
+  subscription->last_sent_value.reset();
+}
+
+void Commutator::Unsubscribe(Uid subscriber, std::size_t device_index) {
+  subscriptions_.erase(
+      std::remove_if(std::begin(subscriptions_), std::end(subscriptions_),
+                     [&](auto const& subscription) {
+                       return (subscription.subscriber == subscriber) &&
+                              (subscription.device_index == device_index);
+                     }),
+      std::end(subscriptions_));
+  UpdateSubscribed(subscriber);
+}
+
+void Commutator::UnsubscribeAll(Uid const& subscriber) {
+  subscriptions_.erase(
+      std::remove_if(std::begin(subscriptions_), std::end(subscriptions_),
+                     [&](auto const& subscription) {
+                       return subscription.subscriber == subscriber;
+                     }),
+      std::end(subscriptions_));
+}
+
+void Commutator::UpdateSubscribed(Uid const& subscriber) {
+  auto subscribed =
+      std::any_of(std::begin(subscriptions_), std::end(subscriptions_),
+                  [&](auto const& subscription) {
+                    return subscription.subscriber == subscriber;
+                  });
+  streams_.SetSubscribed(subscriber, subscribed, Now());
+}
+
+Commutator::StateSubscription* Commutator::FindSubscription(
+    Uid const& subscriber, std::size_t device_index) {
+  auto it = std::find_if(std::begin(subscriptions_), std::end(subscriptions_),
+                         [&](auto const& subscription) {
+                           return (subscription.subscriber == subscriber) &&
+                                  (subscription.device_index == device_index);
+                         });
+  return (it != std::end(subscriptions_)) ? &*it : nullptr;
+}
+
+void Commutator::CheckSubscribedDevice(std::size_t device_index) {
+  auto* device = devices_.Find(device_index);
+  assert(device && "Subscriptions are removed together with the device");
+  auto state_action = state_cache_.GetState(device_index, *device);
+  state_action->StatusEvent().Subscribe(ActionHandler{
+      OnResult{[this, device_index](auto const& action) {
+        BroadcastState(device_index, action.state_data());
+      }},
+      OnError{[this, device_index]() {
+        for (auto& subscription : subscriptions_) {
+          if (subscription.device_index == device_index) {
+            subscription.reading = false;
+          }
         }
-      }));
+      }},
+  });
 }
 
-void Commutator::OnNewMessage(RcPtr<P2pStream> stream, DataBuffer const& data) {
-  auto api_impl = CommutatorApiImpl{*this, std::move(stream)};
-  auto parser = ApiParser{protocol_context_, data};
-  parser.Parse(api_impl);
+void Commutator::BroadcastState(std::size_t device_index,
+                                DeviceStateData const& state) {
+  auto value = NumericValue(state.payload);
+  std::optional<DataBuffer> message;
+  for (auto& subscription : subscriptions_) {
+    // subscriptions made while reading wait for their own check
+    if ((subscription.device_index != device_index) || !subscription.reading) {
+      continue;
+    }
+    subscription.reading = false;
+    if (value && subscription.last_sent_value &&
+        (std::abs(*value - *subscription.last_sent_value) <=
+         subscription.deadband)) {
+      continue;
+    }
+    if (!message) {
+      auto api_context = ApiContext{client_api_};
+      api_context->device_state_updated(static_cast<int>(device_index), state);
+      message = DataBuffer{std::move(api_context)};
+    }
+    subscription.last_sent_value = value;
+    // the stream takes the buffer by value, the only per subscriber cost
+    subscription.api_impl->stream().Write(DataBuffer{*message});
+  }
 }
 
+void Commutator::OnNewStream(RcPtr<P2pStream> stream) {
+  auto uid = stream->destination();
+  auto& byte_stream = *stream;
+  ServeStream(uid, byte_stream, std::move(stream));
+}
+
+void Commutator::ServeStream(Uid const& client_uid, ByteIStream& stream,
+                             RcPtr<P2pStream> owned_stream) {
+  std::unique_ptr<CommutatorApiImpl> new_api_impl;
+  auto* api_impl = FindApiImpl(client_uid);
+  if (api_impl != nullptr) {
+    // the client has opened a new stream, its subscriptions stay with it
+    api_impl->set_stream(stream);
+  } else {
+    new_api_impl =
+        std::make_unique<CommutatorApiImpl>(*this, client_uid, stream);
+    api_impl = new_api_impl.get();
+  }
+  // the subscription is removed together with the dispatcher
+  auto message_sub = stream.out_data_event().Subscribe(
+      [this, api_impl](DataBuffer const& data) {
+        OnNewMessage(*api_impl, data);
+      });
+  streams_.Add(client_uid, std::move(owned_stream), std::move(new_api_impl),
+               std::move(message_sub), Now());
+}
+
+void Commutator::OnNewMessage(CommutatorApiImpl& api_impl,
+                              DataBuffer const& data) {
+  streams_.Touch(api_impl.client_uid(), Now());
+  api_impl.OnMessage(data);
+}
+
+CommutatorApiImpl* Commutator::FindApiImpl(Uid const& client_uid) {
+  auto* entry = streams_.Find(client_uid);
+  return (entry != nullptr) ? entry->api_impl.get() : nullptr;
+}
 }  // namespace ae
@@ -17,37 +17,161 @@
 #ifndef COMUTATOR_H_
 #define COMUTATOR_H_
 
-#include <map>
 #include <vector>
 #include <memory>
+#include <cstddef>
+#include <optional>
 
 #include "aether/all.h"
 
 #include "api/api.h"
 #include "idevice.h"
+#include "stream_table.h"
+#include "device_history.h"
+#include "request_metrics.h"
+#include "device_registry.h"
+#include "sampling_scheduler.h"
+#include "device_state_cache.h"
+#include "actor_command_queue.h"
 
 namespace ae {
+struct CommutatorConfig {
+  // device state not older than this is answered from the cache
+  Duration state_max_age = std::chrono::seconds{1};
+  // client streams kept at once, the least recently active one is removed
+  std::size_t max_stream_count = 32;
+  // a client stream without incoming messages and state subscriptions for
+  // this time is removed
+  Duration stream_idle_timeout = std::chrono::minutes{10};
+  // an actor runs commands not more often than this, except safety ones
+  Duration actor_command_interval = std::chrono::milliseconds{100};
+};
+
 class Commutator {
   friend class CommutatorApiImpl;
 
  public:
-  explicit Commutator(Client::ptr const& client);
+  /**
+   * \brief Commutator serving the streams opened to the client.
+   */
+  Commutator(ActionContext action_context, Client::ptr const& client,
+             CommutatorConfig const& config = {});
+  /**
+   * \brief Commutator serving only the streams added by AddStream.
+   */
+  explicit Commutator(ActionContext action_context,
+                      CommutatorConfig const& config = {});
 
-  void AddDevice(std::unique_ptr<IDevice>&& device);
+  /**
+   * \brief Register the device, returns its local id.
+   */
+  std::size_t AddDevice(std::unique_ptr<IDevice>&& device);
+  /**
+   * \brief Unregister the device and drop its subscriptions.
+   * Returns false if there is no such device.
+   */
+  bool RemoveDevice(std::size_t local_id);
+  /**
+   * \brief Read the device in the background each period and answer its
+   * state queries with the latest sample. The numeric samples are kept in the
+   * device's history. A zero period stops the sampling.
+   */
+  void SetSamplingPeriod(std::size_t local_id, Duration period);
+  /**
+   * \brief Set the minimal interval between the actor's commands, instead of
+   * CommutatorConfig::actor_command_interval.
+   */
+  void SetCommandInterval(std::size_t local_id, Duration interval);
+  /**
+   * \brief Serve the requests coming from a stream owned by the caller.
+   * The stream must be kept until RemoveStream or the commutator's
+   * destruction.
+   */
+  void AddStream(Uid const& client_uid, ByteIStream& stream);
+  /**
+   * \brief Stop serving the client's stream, as on the client's disconnect,
+   * and drop its subscriptions. The stream added by AddStream may be destroyed
+   * after it.
+   */
+  void RemoveStream(Uid const& client_uid);
+
+  /**
+   * \brief Sample the devices, check the subscribed device states and push
+   * the changed ones.
+   * Must be called on each application loop iteration.
+   * Returns the time it should be called next.
+   */
+  TimePoint Update(TimePoint current_time);
 
  private:
+  struct StateSubscription {
+    Uid subscriber;
+    // valid while subscribed, the subscriptions are removed with the stream
+    CommutatorApiImpl* api_impl;
+    std::size_t device_index;
+    Duration min_interval;
+    double deadband;
+    TimePoint next_check_time;
+    std::optional<double> last_sent_value;
+    bool reading;
+  };
   void OnNewStream(RcPtr<P2pStream> stream);
-  void OnNewMessage(RcPtr<P2pStream> stream, DataBuffer const& data);
-  void SendSensorsState(RcPtr<P2pStream> const& stream);
+  void ServeStream(Uid const& client_uid, ByteIStream& stream,
+                   RcPtr<P2pStream> owned_stream);
+  void OnNewMessage(CommutatorApiImpl& api_impl, DataBuffer const& data);
+  /**
+   * \brief Dispatcher of the client's stream, nullptr if it is closed.
+   */
+  CommutatorApiImpl* FindApiImpl(Uid const& client_uid);
+  /**
+   * \brief Answer each request merged into the done command.
+   */
+  void CommandDone(std::size_t local_id,
+                   std::vector<ActorCommandQueue::Requester> const& requesters,
+                   DeviceStateData const* state);
+  void SendSensorsState(Uid const& client_uid);
+  /**
+   * \brief Collect the states of all devices and send them in one message,
+   * as a list or encoded by PackStates.
+   */
+  void SendSensorsStateBatch(Uid const& client_uid, bool packed,
+                             TimePoint request_time);
+  CommutatorMetrics CollectMetrics(TimePoint current_time) const;
+
+  void Subscribe(CommutatorApiImpl& subscriber, std::size_t device_index,
+                 Duration min_interval, double deadband);
+  void Unsubscribe(Uid subscriber, std::size_t device_index);
+  void UnsubscribeAll(Uid const& subscriber);
+  /**
+   * \brief Keep the subscriber's stream while it has subscriptions.
+   */
+  void UpdateSubscribed(Uid const& subscriber);
+  StateSubscription* FindSubscription(Uid const& subscriber,
+                                      std::size_t device_index);
+  /**
+   * \brief Read the device for all its due subscriptions at once.
+   */
+  void CheckSubscribedDevice(std::size_t device_index);
+  /**
+   * \brief Serialize the state once and write it to each due subscriber.
+   */
+  void BroadcastState(std::size_t device_index, DeviceStateData const& state);
 
   PtrView<Client> client_;
   ProtocolContext protocol_context_;
   SmartHomeClientApi client_api_;
-  std::vector<std::unique_ptr<IDevice>> devices_;
+  DeviceRegistry devices_;
+  DeviceStateCache state_cache_;
+  SamplingScheduler sampler_;
+  HistoryStore history_;
+  ActorCommandQueue commands_;
+  RequestMetrics metrics_;
 
-  std::map<Uid, RcPtr<P2pStream>> streams_;
+  StreamTable streams_;
+  std::vector<StateSubscription> subscriptions_;
+  // devices with due subscriptions, kept to not allocate on each update
+  std::vector<std::size_t> due_devices_;
   Subscription new_request_sub_;
-  MultiSubscription new_message_subs_;
 };
 }  // namespace ae
 
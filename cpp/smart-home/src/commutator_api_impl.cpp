@@ -16,76 +16,210 @@
 
 #include "commutator_api_impl.h"
 
+#include <limits>
+#include <utility>
+#include <algorithm>
+
 #include "idevice.h"
 #include "commutator.h"
 
 namespace ae {
-CommutatorApiImpl::CommutatorApiImpl(Commutator& commutator,
-                                     RcPtr<P2pStream> stream)
+namespace {
+// the history reply is kept within this number of buckets
+constexpr std::int64_t kMaxHistoryBuckets = 512;
+}  // namespace
+
+CommutatorApiImpl::CommutatorApiImpl(Commutator& commutator, Uid client_uid,
+                                     ByteIStream& stream)
     : SmartHomeCommutatorApi{commutator.protocol_context_},
       commutator_{&commutator},
-      stream_{std::move(stream)} {}
+      client_uid_{client_uid},
+      stream_{&stream},
+      return_result_api_{commutator.protocol_context_} {}
+
+void CommutatorApiImpl::OnMessage(DataBuffer const& data) {
+  request_time_ = Now();
+  // the parser only reads through the message, it has no state worth keeping
+  auto parser = ApiParser{protocol_context(), data};
+  parser.Parse(*this);
+}
+
+void CommutatorApiImpl::SendError(RequestId request_id,
+                                  std::uint32_t error_code) {
+  auto api_call = ApiCallAdapter{ApiContext{return_result_api_}, *stream_};
+  api_call->SendError(request_id, error_code, 1);
+  api_call.Flush();
+}
 
 void CommutatorApiImpl::GetSystemStructure(
     PromiseResult<std::vector<HardwareDevice>> result) {
+  commutator_->metrics_.Begin();
   std::vector<HardwareDevice> hw_devices;
   hw_devices.reserve(commutator_->devices_.size());
-  for (auto& d : commutator_->devices_) {
-    hw_devices.emplace_back(d->description());
-  }
-
-  ReturnResultApi ret{protocol_context()};
-  auto api_call = ApiCallAdapter{ApiContext{ret}, *stream_};
-
-  api_call->SendResult(result.request_id, std::move(hw_devices));
-  api_call.Flush();
+  commutator_->devices_.ForEach([&](std::size_t, IDevice& device) {
+    hw_devices.emplace_back(device.description());
+  });
+  SendResult(result.request_id, std::move(hw_devices));
+  Answered(kGetSystemStructureId);
 }
 
 void CommutatorApiImpl::ExecuteActorCommand(
     PromiseResult<DeviceStateData> result, int local_actor_id,
     VariantData command) {
-  auto dev_id = static_cast<std::size_t>(local_actor_id);
+  PushCommand(result, local_actor_id, std::move(command),
+              static_cast<std::uint8_t>(CommandPriority::kNormal),
+              kExecuteActorCommandId);
+}
 
-  if (dev_id >= commutator_->devices_.size()) {
-    // index out of range
-    ReturnResultApi ret{protocol_context()};
-    auto api_call = ApiCallAdapter{ApiContext{ret}, *stream_};
-    api_call->SendError(result.request_id, 1, 1);
-  }
-  auto& device = commutator_->devices_[dev_id];
-  auto state_action = device->Execute(command);
-  state_action->StatusEvent().Subscribe(OnResult{
-      [pc{&protocol_context()}, stream{stream_}, result](auto const& action) {
-        ReturnResultApi ret{*pc};
-        auto api_call = ApiCallAdapter{ApiContext{ret}, *stream};
-        api_call->SendResult(result.request_id, action.state_data());
-        api_call.Flush();
-      }});
+void CommutatorApiImpl::ExecuteActorCommandWithPriority(
+    PromiseResult<DeviceStateData> result, int local_actor_id,
+    VariantData command, std::uint8_t priority) {
+  PushCommand(result, local_actor_id, std::move(command), priority,
+              kExecuteActorCommandWithPriorityId);
 }
 
 void CommutatorApiImpl::QueryState(PromiseResult<DeviceStateData> result,
                                    int local_device_id) {
+  commutator_->metrics_.Begin();
   auto dev_id = static_cast<std::size_t>(local_device_id);
 
-  if (dev_id >= commutator_->devices_.size()) {
-    // index out of range
-    ReturnResultApi ret{protocol_context()};
-    auto api_call = ApiCallAdapter{ApiContext{ret}, *stream_};
-    api_call->SendError(result.request_id, 2, 1);
+  auto* device = commutator_->devices_.Find(dev_id);
+  if (device == nullptr) {
+    // no such device
+    SendError(result.request_id, 2);
+    Answered(kQueryStateId, false);
+    return;
   }
-  auto& device = commutator_->devices_[dev_id];
-  auto state_action = device->GetState();
-  state_action->StatusEvent().Subscribe(OnResult{
-      [pc{&protocol_context()}, stream{stream_}, result](auto const& action) {
-        ReturnResultApi ret{*pc};
-        auto api_call = ApiCallAdapter{ApiContext{ret}, *stream};
-        api_call->SendResult(result.request_id, action.state_data());
-        api_call.Flush();
-      }});
+  auto state_action = commutator_->state_cache_.GetState(dev_id, *device);
+  state_action->StatusEvent().Subscribe(ActionHandler{
+      OnResult{[commutator{commutator_}, client_uid{client_uid_},
+                request_id{result.request_id},
+                request_time{request_time_}](auto const& action) {
+        if (auto* api_impl = commutator->FindApiImpl(client_uid); api_impl) {
+          api_impl->SendResult(request_id, action.state_data());
+        }
+        commutator->metrics_.Record(kQueryStateId, request_time, true);
+      }},
+      OnError{[commutator{commutator_}, client_uid{client_uid_},
+               request_id{result.request_id}, request_time{request_time_}]() {
+        // the device read has failed
+        if (auto* api_impl = commutator->FindApiImpl(client_uid); api_impl) {
+          api_impl->SendError(request_id, 4);
+        }
+        commutator->metrics_.Record(kQueryStateId, request_time, false);
+      }},
+  });
+}
+
+void CommutatorApiImpl::GetStructureVersion(
+    PromiseResult<std::uint32_t> result) {
+  commutator_->metrics_.Begin();
+  SendResult(result.request_id, commutator_->devices_.structure_version());
+  Answered(kGetStructureVersionId);
 }
 
 void CommutatorApiImpl::QueryAllSensorStates() {
-  commutator_->SendSensorsState(stream_);
+  // the states are sent separately, only the dispatch is measured
+  commutator_->metrics_.Begin();
+  commutator_->SendSensorsState(client_uid_);
+  Answered(kQueryAllSensorStatesId);
+}
+
+void CommutatorApiImpl::QueryAllSensorStatesBatch() {
+  commutator_->metrics_.Begin();
+  commutator_->SendSensorsStateBatch(client_uid_, false, request_time_);
+}
+
+void CommutatorApiImpl::QueryAllSensorStatesPacked() {
+  commutator_->metrics_.Begin();
+  commutator_->SendSensorsStateBatch(client_uid_, true, request_time_);
 }
 
+void CommutatorApiImpl::SubscribeState(int local_device_id,
+                                       std::uint32_t min_interval_ms,
+                                       double deadband) {
+  commutator_->metrics_.Begin();
+  auto dev_id = static_cast<std::size_t>(local_device_id);
+  if (commutator_->devices_.Find(dev_id) == nullptr) {
+    Answered(kSubscribeStateId, false);
+    return;
+  }
+  commutator_->Subscribe(*this, dev_id,
+                         std::chrono::milliseconds{min_interval_ms}, deadband);
+  Answered(kSubscribeStateId);
+}
+
+void CommutatorApiImpl::UnsubscribeState(int local_device_id) {
+  commutator_->metrics_.Begin();
+  commutator_->Unsubscribe(client_uid_,
+                           static_cast<std::size_t>(local_device_id));
+  Answered(kUnsubscribeStateId);
+}
+
+void CommutatorApiImpl::QueryHistory(
+    PromiseResult<std::vector<HistoryBucket>> result, int local_device_id,
+    std::int64_t from, std::int64_t to, std::uint32_t resolution) {
+  commutator_->metrics_.Begin();
+  auto dev_id = static_cast<std::size_t>(local_device_id);
+  if (commutator_->devices_.Find(dev_id) == nullptr) {
+    // no such device
+    SendError(result.request_id, 3);
+    Answered(kQueryHistoryId, false);
+    return;
+  }
+  auto const* history = commutator_->history_.Find(dev_id);
+  if (history != nullptr) {
+    // the range is the client's, clamp it to the kept one, so the span below
+    // does not overflow
+    from = std::max(from, history->begin_time());
+    to = std::min(to, history->end_time());
+  }
+  if ((history == nullptr) || (to <= from)) {
+    SendResult(result.request_id, std::vector<HistoryBucket>{});
+    Answered(kQueryHistoryId);
+    return;
+  }
+  auto min_resolution =
+      (to - from + kMaxHistoryBuckets - 1) / kMaxHistoryBuckets;
+  if (min_resolution > static_cast<std::int64_t>(resolution)) {
+    resolution = static_cast<std::uint32_t>(std::min<std::int64_t>(
+        min_resolution, std::numeric_limits<std::uint32_t>::max()));
+  }
+  SendResult(result.request_id, history->Query(from, to, resolution));
+  Answered(kQueryHistoryId);
+}
+
+void CommutatorApiImpl::GetMetrics(PromiseResult<CommutatorMetrics> result) {
+  commutator_->metrics_.Begin();
+  SendResult(result.request_id, commutator_->CollectMetrics(Now()));
+  Answered(kGetMetricsId);
+}
+
+void CommutatorApiImpl::PushCommand(PromiseResult<DeviceStateData> result,
+                                    int local_actor_id, VariantData command,
+                                    std::uint8_t priority,
+                                    std::uint8_t method_id) {
+  commutator_->metrics_.Begin();
+  auto dev_id = static_cast<std::size_t>(local_actor_id);
+  if (commutator_->devices_.Find(dev_id) == nullptr) {
+    // no such device
+    SendError(result.request_id, 1);
+    Answered(method_id, false);
+    return;
+  }
+  if (priority > static_cast<std::uint8_t>(CommandPriority::kSafety)) {
+    // an unknown level must not bypass the rate limit as a safety command
+    SendError(result.request_id, 5);
+    Answered(method_id, false);
+    return;
+  }
+  // answered by Commutator::CommandDone
+  commutator_->commands_.Push(
+      dev_id, std::move(command), static_cast<CommandPriority>(priority),
+      {client_uid_, result.request_id, method_id, request_time_});
+}
+
+void CommutatorApiImpl::Answered(std::uint8_t method_id, bool success) {
+  commutator_->metrics_.Record(method_id, request_time_, success);
+}
 }  // namespace ae
@@ -17,15 +17,42 @@
 #ifndef COMMUTATOR_API_IMPL_H_
 #define COMMUTATOR_API_IMPL_H_
 
+#include <utility>
+
 #include "aether/all.h"
 
 #include "api/api.h"
 
 namespace ae {
 class Commutator;
+/**
+ * \brief Requests dispatcher of one client stream.
+ * Lives as long as the stream is served, so the request path reuses it and its
+ * reply API instead of building them for each message. Replies to the requests
+ * completed later are routed back through the commutator by the client's uid,
+ * as the stream may be closed by then.
+ */
 class CommutatorApiImpl : public SmartHomeCommutatorApi {
  public:
-  CommutatorApiImpl(Commutator& commutator, RcPtr<P2pStream> stream);
+  CommutatorApiImpl(Commutator& commutator, Uid client_uid,
+                    ByteIStream& stream);
+
+  /**
+   * \brief Parse the request message and call the requested methods.
+   */
+  void OnMessage(DataBuffer const& data);
+
+  template <typename T>
+  void SendResult(RequestId request_id, T&& value) {
+    auto api_call = ApiCallAdapter{ApiContext{return_result_api_}, *stream_};
+    api_call->SendResult(request_id, std::forward<T>(value));
+    api_call.Flush();
+  }
+  void SendError(RequestId request_id, std::uint32_t error_code);
+
+  Uid const& client_uid() const { return client_uid_; }
+  ByteIStream& stream() { return *stream_; }
+  void set_stream(ByteIStream& stream) { stream_ = &stream; }
 
   void GetSystemStructure(
       PromiseResult<std::vector<HardwareDevice>> result) override;
@@ -33,14 +60,47 @@ class CommutatorApiImpl : public SmartHomeCommutatorApi {
   void ExecuteActorCommand(PromiseResult<DeviceStateData> result,
                            int local_actor_id, VariantData command) override;
 
+  void ExecuteActorCommandWithPriority(PromiseResult<DeviceStateData> result,
+                                       int local_actor_id, VariantData command,
+                                       std::uint8_t priority) override;
+
   void QueryState(PromiseResult<DeviceStateData> result,
                   int local_device_id) override;
 
+  void GetStructureVersion(PromiseResult<std::uint32_t> result) override;
+
   void QueryAllSensorStates() override;
 
+  void QueryAllSensorStatesBatch() override;
+
+  void QueryAllSensorStatesPacked() override;
+
+  void SubscribeState(int local_device_id, std::uint32_t min_interval_ms,
+                      double deadband) override;
+
+  void UnsubscribeState(int local_device_id) override;
+
+  void QueryHistory(PromiseResult<std::vector<HistoryBucket>> result,
+                    int local_device_id, std::int64_t from, std::int64_t to,
+                    std::uint32_t resolution) override;
+
+  void GetMetrics(PromiseResult<CommutatorMetrics> result) override;
+
  private:
+  void PushCommand(PromiseResult<DeviceStateData> result, int local_actor_id,
+                   VariantData command, std::uint8_t priority,
+                   std::uint8_t method_id);
+  /**
+   * \brief Record the metrics of the request answered right away.
+   */
+  void Answered(std::uint8_t method_id, bool success = true);
+
   Commutator* commutator_;
-  RcPtr<P2pStream> stream_;
+  Uid client_uid_;
+  ByteIStream* stream_;
+  ReturnResultApi return_result_api_;
+  // parse time of the message being dispatched
+  TimePoint request_time_;
 };
 }  // namespace ae
 
@@ -0,0 +1,182 @@
+/*
+ * Copyright 2025 Aethernet Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "device_history.h"
+
+#include <algorithm>
+
+namespace ae {
+namespace {
+std::int64_t FloorTo(std::int64_t time, std::int64_t duration) {
+  return time - (((time % duration) + duration) % duration);
+}
+
+// slot of the bucket starting at start_time, the time may be negative
+std::size_t RingIndex(std::int64_t start_time, std::int64_t duration,
+                      std::int64_t count) {
+  return static_cast<std::size_t>((((start_time / duration) % count) + count) %
+                                  count);
+}
+}  // namespace
+
+DeviceHistory::DeviceHistory() {
+  for (std::size_t i = 0; i < kTiers.size(); ++i) {
+    tiers_[i] = std::make_unique<Bucket[]>(kTiers[i].bucket_count);
+  }
+}
+
+void DeviceHistory::Add(std::int64_t timestamp, double value) {
+  if (!has_values_) {
+    earliest_time_ = timestamp;
+    latest_time_ = timestamp;
+    has_values_ = true;
+  }
+  earliest_time_ = std::min(earliest_time_, timestamp);
+  latest_time_ = std::max(latest_time_, timestamp);
+  for (std::size_t i = 0; i < kTiers.size(); ++i) {
+    auto duration = static_cast<std::int64_t>(kTiers[i].bucket_duration);
+    auto count = static_cast<std::int64_t>(kTiers[i].bucket_count);
+    auto start_time = FloorTo(timestamp, duration);
+    if (start_time + duration * count <= latest_time_) {
+      // the ring has already moved past this bucket
+      continue;
+    }
+    auto& bucket = tiers_[i][RingIndex(start_time, duration, count)];
+    if ((bucket.count == 0) || (bucket.start_time != start_time)) {
+      if ((bucket.count != 0) && (bucket.start_time > start_time)) {
+        continue;
+      }
+      // reuse the slot of the oldest bucket
+      bucket = Bucket{start_time, static_cast<float>(value),
+                      static_cast<float>(value), 0, 0};
+    }
+    bucket.min = std::min(bucket.min, static_cast<float>(value));
+    bucket.max = std::max(bucket.max, static_cast<float>(value));
+    bucket.sum += value;
+    ++bucket.count;
+  }
+}
+
+std::vector<HistoryBucket> DeviceHistory::Query(
+    std::int64_t from, std::int64_t to, std::uint32_t resolution) const {
+  if (!has_values_) {
+    return {};
+  }
+  resolution = std::max(resolution, std::uint32_t{1});
+  auto tier_index = SelectTier(from, resolution);
+  auto const& tier = kTiers[tier_index];
+  auto duration = static_cast<std::int64_t>(tier.bucket_duration);
+  auto count = static_cast<std::int64_t>(tier.bucket_count);
+  // the output bucket is a whole number of the tier buckets
+  auto out_duration =
+      ((static_cast<std::int64_t>(resolution) + duration - 1) / duration) *
+      duration;
+  // nothing is kept before the ring's reach or the earliest value and after
+  // the latest value, the range is clamped first to not overflow with any from
+  // and to
+  auto first_time =
+      std::max(FloorTo(latest_time_, duration) - (duration * (count - 1)),
+               FloorTo(earliest_time_, duration));
+  auto start_time = (from > first_time) ? FloorTo(from, duration) : first_time;
+  to = std::min(to, end_time());
+
+  std::vector<HistoryBucket> result;
+  double sum = 0;
+  auto finish_bucket = [&]() {
+    if (!result.empty()) {
+      result.back().avg = sum / static_cast<double>(result.back().count);
+    }
+  };
+  for (; start_time < to; start_time += duration) {
+    auto const& bucket =
+        tiers_[tier_index][RingIndex(start_time, duration, count)];
+    if ((bucket.count == 0) || (bucket.start_time != start_time)) {
+      continue;
+    }
+    auto out_start_time = FloorTo(start_time, out_duration);
+    if (result.empty() || (result.back().start_time != out_start_time)) {
+      finish_bucket();
+      sum = 0;
+      result.push_back(HistoryBucket{
+          out_start_time, static_cast<std::uint32_t>(out_duration),
+          bucket.min, bucket.max, 0, 0});
+    }
+    auto& out = result.back();
+    out.min = std::min(out.min, static_cast<double>(bucket.min));
+    out.max = std::max(out.max, static_cast<double>(bucket.max));
+    out.count += bucket.count;
+    sum += bucket.sum;
+  }
+  finish_bucket();
+  return result;
+}
+
+std::int64_t DeviceHistory::begin_time() const {
+  auto const& tier = kTiers.back();
+  auto duration = static_cast<std::int64_t>(tier.bucket_duration);
+  return std::max(
+      FloorTo(latest_time_, duration) -
+          (duration * static_cast<std::int64_t>(tier.bucket_count - 1)),
+      earliest_time_);
+}
+
+std::int64_t DeviceHistory::end_time() const { return latest_time_ + 1; }
+
+std::size_t DeviceHistory::SelectTier(std::int64_t from,
+                                      std::uint32_t resolution) const {
+  // nothing is kept before the earliest value, any tier reaching it keeps all
+  from = std::max(from, earliest_time_);
+  auto selected = kTiers.size() - 1;
+  for (std::size_t i = 0; i < kTiers.size(); ++i) {
+    auto duration = static_cast<std::int64_t>(kTiers[i].bucket_duration);
+    // start of the oldest bucket in the ring
+    auto reach =
+        FloorTo(latest_time_, duration) -
+        (duration * static_cast<std::int64_t>(kTiers[i].bucket_count - 1));
+    if (reach > from) {
+      continue;
+    }
+    selected = i;
+    if ((i + 1 == kTiers.size()) ||
+        (kTiers[i + 1].bucket_duration > resolution)) {
+      break;
+    }
+  }
+  return selected;
+}
+
+void HistoryStore::Add(std::size_t local_id, std::int64_t timestamp,
+                       double value) {
+  if (local_id >= histories_.size()) {
+    histories_.resize(local_id + 1);
+  }
+  auto& history = histories_[local_id];
+  if (!history) {
+    history = std::make_unique<DeviceHistory>();
+  }
+  history->Add(timestamp, value);
+}
+
+void HistoryStore::Remove(std::size_t local_id) {
+  if (local_id < histories_.size()) {
+    histories_[local_id].reset();
+  }
+}
+
+DeviceHistory const* HistoryStore::Find(std::size_t local_id) const {
+  return (local_id < histories_.size()) ? histories_[local_id].get() : nullptr;
+}
+}  // namespace ae
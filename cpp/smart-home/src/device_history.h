@@ -0,0 +1,109 @@
+/*
+ * Copyright 2025 Aethernet Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef DEVICE_HISTORY_H_
+#define DEVICE_HISTORY_H_
+
+#include <array>
+#include <memory>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+#include "api/types.h"
+
+namespace ae {
+/**
+ * \brief Downsampled history of a numeric device state in fixed memory.
+ * Each tier is a ring of buckets of the same duration, keeping min, max, sum
+ * and count of the values got in the bucket's time. A value is added to the
+ * current bucket of every tier, so the fine tiers keep the recent hours and the
+ * coarse ones keep the whole week.
+ */
+class DeviceHistory {
+ public:
+  struct Tier {
+    std::uint32_t bucket_duration;  // seconds
+    std::size_t bucket_count;
+  };
+  static constexpr std::array kTiers{
+      Tier{60, 120},    // 1 minute buckets for 2 hours
+      Tier{900, 96},    // 15 minutes buckets for a day
+      Tier{3600, 168},  // 1 hour buckets for a week
+  };
+
+  DeviceHistory();
+
+  /**
+   * \brief Add the value got at timestamp in seconds.
+   * A value older than its tier's ring is dropped.
+   */
+  void Add(std::int64_t timestamp, double value);
+
+  /**
+   * \brief Buckets of the given duration in [from, to) seconds.
+   * Uses the coarsest tier not coarser than the resolution that still keeps
+   * the from time, or the coarsest tier if none keeps it, and merges its
+   * buckets to the resolution. Only the buckets with values are returned.
+   * Only the kept buckets are visited, whatever the range.
+   */
+  std::vector<HistoryBucket> Query(std::int64_t from, std::int64_t to,
+                                   std::uint32_t resolution) const;
+
+  /**
+   * \brief The range [begin_time, end_time) in seconds the history may keep
+   * values for, from the earliest value still in reach to the latest one.
+   */
+  std::int64_t begin_time() const;
+  std::int64_t end_time() const;
+
+ private:
+  struct Bucket {
+    std::int64_t start_time;
+    float min;
+    float max;
+    double sum;
+    std::uint32_t count;
+  };
+  using Ring = std::unique_ptr<Bucket[]>;
+
+  std::size_t SelectTier(std::int64_t from, std::uint32_t resolution) const;
+
+  std::array<Ring, kTiers.size()> tiers_;
+  std::int64_t earliest_time_{};
+  std::int64_t latest_time_{};
+  bool has_values_{};
+};
+
+/**
+ * \brief History of each device, created with the device's first value.
+ */
+class HistoryStore {
+ public:
+  void Add(std::size_t local_id, std::int64_t timestamp, double value);
+  void Remove(std::size_t local_id);
+  /**
+   * \brief Device's history or nullptr if it has no values.
+   */
+  DeviceHistory const* Find(std::size_t local_id) const;
+
+ private:
+  // indexed by local id
+  std::vector<std::unique_ptr<DeviceHistory>> histories_;
+};
+}  // namespace ae
+
+#endif  // DEVICE_HISTORY_H_
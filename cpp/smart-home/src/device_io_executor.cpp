@@ -0,0 +1,195 @@
+/*
+ * Copyright 2025 Aethernet Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "device_io_executor.h"
+
+#include <cassert>
+#include <cstdint>
+#include <utility>
+#include <algorithm>
+
+namespace ae {
+namespace {
+// how often the loop checks for the completions while the work is in flight
+constexpr auto kPollInterval = std::chrono::milliseconds{5};
+// the completion triggers the action, this only bounds a missed trigger
+constexpr auto kActionWaitInterval = std::chrono::seconds{1};
+// how long Update may sleep without work in flight
+constexpr auto kIdleUpdateInterval = std::chrono::seconds{60};
+
+#if defined ESP_PLATFORM
+constexpr std::uint32_t kTaskStackSize = 4096;
+constexpr UBaseType_t kTaskPriority = tskIDLE_PRIORITY + 1;
+constexpr UBaseType_t kJobQueueSize = 16;
+#endif
+}  // namespace
+
+DeviceIoExecutor::DeviceIoExecutor(std::size_t worker_count)
+    : worker_count_{worker_count} {
+#if defined ESP_PLATFORM
+  // one task is enough for the buses of one chip
+  worker_count_ = std::min<std::size_t>(worker_count_, 1);
+#endif
+  for (std::size_t i = 0; i < worker_count_; ++i) {
+    done_rings_.push_back(std::make_unique<DoneRing>());
+  }
+  if (worker_count_ == 0) {
+    return;
+  }
+#if defined ESP_PLATFORM
+  jobs_ = xQueueCreate(kJobQueueSize, sizeof(Job*));
+  task_stopped_ = xSemaphoreCreateBinary();
+  xTaskCreate(&DeviceIoExecutor::TaskMain, "device_io", kTaskStackSize, this,
+              kTaskPriority, nullptr);
+#else
+  for (std::size_t i = 0; i < worker_count_; ++i) {
+    workers_.emplace_back([this, i]() { RunWorker(i); });
+  }
+#endif
+}
+
+DeviceIoExecutor::~DeviceIoExecutor() {
+  if (worker_count_ == 0) {
+    return;
+  }
+#if defined ESP_PLATFORM
+  // null job stops the task
+  Job* stop = nullptr;
+  xQueueSend(jobs_, &stop, portMAX_DELAY);
+  xSemaphoreTake(task_stopped_, portMAX_DELAY);
+  vSemaphoreDelete(task_stopped_);
+  vQueueDelete(jobs_);
+#else
+  {
+    auto lock = std::lock_guard{jobs_mutex_};
+    stopped_ = true;
+  }
+  jobs_cv_.notify_all();
+  for (auto& worker : workers_) {
+    worker.join();
+  }
+#endif
+}
+
+void DeviceIoExecutor::Post(Work work, Work done) {
+  if (worker_count_ == 0) {
+    work();
+    done();
+    return;
+  }
+  ++in_flight_count_;
+#if defined ESP_PLATFORM
+  auto* job = new Job{std::move(work), std::move(done)};
+  xQueueSend(jobs_, &job, portMAX_DELAY);
+#else
+  {
+    auto lock = std::lock_guard{jobs_mutex_};
+    jobs_.push_back(Job{std::move(work), std::move(done)});
+  }
+  jobs_cv_.notify_one();
+#endif
+}
+
+TimePoint DeviceIoExecutor::Update(TimePoint current_time) {
+  for (auto& ring : done_rings_) {
+    while (auto done = ring->Pop()) {
+      --in_flight_count_;
+      (*done)();
+    }
+  }
+  return (in_flight_count_ != 0) ? current_time + kPollInterval
+                                 : current_time + kIdleUpdateInterval;
+}
+
+#if defined ESP_PLATFORM
+void DeviceIoExecutor::TaskMain(void* executor) {
+  static_cast<DeviceIoExecutor*>(executor)->RunWorker(0);
+  xSemaphoreGive(static_cast<DeviceIoExecutor*>(executor)->task_stopped_);
+  vTaskDelete(nullptr);
+}
+
+void DeviceIoExecutor::RunWorker(std::size_t worker_index) {
+  while (true) {
+    Job* job = nullptr;
+    xQueueReceive(jobs_, &job, portMAX_DELAY);
+    if (job == nullptr) {
+      return;
+    }
+    job->work();
+    PostDone(worker_index, std::move(job->done));
+    delete job;
+  }
+}
+#else
+void DeviceIoExecutor::RunWorker(std::size_t worker_index) {
+  while (true) {
+    auto lock = std::unique_lock{jobs_mutex_};
+    jobs_cv_.wait(lock, [this]() { return stopped_ || !jobs_.empty(); });
+    if (stopped_) {
+      return;
+    }
+    auto job = std::move(jobs_.front());
+    jobs_.pop_front();
+    lock.unlock();
+
+    job.work();
+    PostDone(worker_index, std::move(job.done));
+  }
+}
+#endif
+
+void DeviceIoExecutor::PostDone(std::size_t worker_index, Work done) {
+  auto& ring = *done_rings_[worker_index];
+  // the loop is behind, wait for it instead of dropping a completion
+  while (!ring.Push(done)) {
+#if defined ESP_PLATFORM
+    vTaskDelay(1);
+#else
+    std::this_thread::sleep_for(std::chrono::milliseconds{1});
+#endif
+  }
+}
+
+BlockingStateAction::BlockingStateAction(ActionContext action_context,
+                                         DeviceIoExecutor& executor, Read read)
+    : DeviceStateAction{action_context},
+      result_{std::make_shared<ReadResult>()} {
+  result_->action = this;
+  executor.Post(
+      [result{result_}, read{std::move(read)}]() { result->state = read(); },
+      // run on the loop, as the action
+      [result{result_}]() {
+        result->done = true;
+        if (result->action != nullptr) {
+          result->action->Trigger();
+        }
+      });
+}
+
+BlockingStateAction::~BlockingStateAction() { result_->action = nullptr; }
+
+UpdateStatus BlockingStateAction::Update() {
+  if (!result_->done) {
+    return UpdateStatus::Delay(Now() + kActionWaitInterval);
+  }
+  return result_->state ? UpdateStatus::Result() : UpdateStatus::Error();
+}
+
+DeviceStateData BlockingStateAction::state_data() const {
+  assert(result_->state && "State is read only for the successful action");
+  return *result_->state;
+}
+}  // namespace ae
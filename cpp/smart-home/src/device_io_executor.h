@@ -0,0 +1,144 @@
+/*
+ * Copyright 2025 Aethernet Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef DEVICE_IO_EXECUTOR_H_
+#define DEVICE_IO_EXECUTOR_H_
+
+#include <memory>
+#include <vector>
+#include <cstddef>
+#include <optional>
+#include <functional>
+
+#if defined ESP_PLATFORM
+#  include <freertos/FreeRTOS.h>
+#  include <freertos/queue.h>
+#  include <freertos/semphr.h>
+#  include <freertos/task.h>
+#else
+#  include <deque>
+#  include <mutex>
+#  include <thread>
+#  include <condition_variable>
+#endif
+
+#include "aether/all.h"
+
+#include "idevice.h"
+#include "spsc_ring.h"
+#include "api/types.h"
+
+namespace ae {
+/**
+ * \brief Runs blocking device I/O off the application loop.
+ * The work is run by a small pool of threads on desktop and by a dedicated
+ * FreeRTOS task on ESP32, and its completion is posted back through a
+ * lock-free ring per worker to be run on the loop by Update. So a slow bus
+ * read delays neither the network nor the other devices.
+ * With zero workers the work is run right away on the calling thread.
+ */
+class DeviceIoExecutor {
+ public:
+  using Work = std::function<void()>;
+
+#if defined ESP_PLATFORM
+  static constexpr std::size_t kDefaultWorkerCount = 1;
+#else
+  static constexpr std::size_t kDefaultWorkerCount = 2;
+#endif
+  static constexpr std::size_t kDoneRingSize = 32;
+
+  explicit DeviceIoExecutor(std::size_t worker_count = kDefaultWorkerCount);
+  ~DeviceIoExecutor();
+
+  DeviceIoExecutor(DeviceIoExecutor const&) = delete;
+  DeviceIoExecutor& operator=(DeviceIoExecutor const&) = delete;
+
+  /**
+   * \brief Run work on a worker, then done on the application loop.
+   * Must be called on the application loop.
+   */
+  void Post(Work work, Work done);
+
+  /**
+   * \brief Run the completions posted by the workers.
+   * Must be called on each application loop iteration.
+   * Returns the time it should be called next.
+   */
+  TimePoint Update(TimePoint current_time);
+
+  std::size_t in_flight_count() const { return in_flight_count_; }
+
+ private:
+  struct Job {
+    Work work;
+    Work done;
+  };
+  using DoneRing = SpscRing<Work, kDoneRingSize>;
+
+  void RunWorker(std::size_t worker_index);
+  void PostDone(std::size_t worker_index, Work done);
+
+  std::size_t worker_count_;
+  // one per worker, each worker is the only producer of its ring
+  std::vector<std::unique_ptr<DoneRing>> done_rings_;
+  std::size_t in_flight_count_{};
+
+#if defined ESP_PLATFORM
+  static void TaskMain(void* executor);
+
+  QueueHandle_t jobs_{};
+  SemaphoreHandle_t task_stopped_{};
+#else
+  std::mutex jobs_mutex_;
+  std::condition_variable jobs_cv_;
+  std::deque<Job> jobs_;
+  bool stopped_{};
+  std::vector<std::thread> workers_;
+#endif
+};
+
+/**
+ * \brief Device state read by a blocking function run on DeviceIoExecutor.
+ * The read returns std::nullopt if it failed. It runs on another thread and
+ * the device may be removed meanwhile, so it must only use what it captures.
+ * The action is triggered by the read's completion run in
+ * DeviceIoExecutor::Update, it does not poll.
+ */
+class BlockingStateAction : public DeviceStateAction {
+ public:
+  using Read = std::function<std::optional<DeviceStateData>()>;
+
+  BlockingStateAction(ActionContext action_context, DeviceIoExecutor& executor,
+                      Read read);
+  ~BlockingStateAction() override;
+
+  UpdateStatus Update() override;
+  DeviceStateData state_data() const override;
+
+ private:
+  struct ReadResult {
+    std::optional<DeviceStateData> state;
+    bool done;
+    // the action to trigger on completion, reset when it is destroyed
+    BlockingStateAction* action;
+  };
+  // shared with the posted work, which may outlive the action
+  std::shared_ptr<ReadResult> result_;
+};
+}  // namespace ae
+
+#endif  // DEVICE_IO_EXECUTOR_H_
@@ -0,0 +1,50 @@
+/*
+ * Copyright 2025 Aethernet Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "device_registry.h"
+
+#include <cassert>
+#include <utility>
+
+namespace ae {
+std::size_t DeviceRegistry::Add(std::unique_ptr<IDevice>&& device) {
+  assert(device && "Device cannot be null");
+  auto local_id = devices_.size();
+  device->SetLocalId(static_cast<int>(local_id));
+  devices_.push_back(std::move(device));
+  ++count_;
+  ++structure_version_;
+  AE_TELED_INFO("Device {} added, structure version {}", local_id,
+                structure_version_);
+  return local_id;
+}
+
+bool DeviceRegistry::Remove(std::size_t local_id) {
+  if ((local_id >= devices_.size()) || !devices_[local_id]) {
+    return false;
+  }
+  devices_[local_id].reset();
+  --count_;
+  ++structure_version_;
+  AE_TELED_INFO("Device {} removed, structure version {}", local_id,
+                structure_version_);
+  return true;
+}
+
+IDevice* DeviceRegistry::Find(std::size_t local_id) const {
+  return (local_id < devices_.size()) ? devices_[local_id].get() : nullptr;
+}
+}  // namespace ae
@@ -0,0 +1,72 @@
+/*
+ * Copyright 2025 Aethernet Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef DEVICE_REGISTRY_H_
+#define DEVICE_REGISTRY_H_
+
+#include <memory>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+#include "idevice.h"
+
+namespace ae {
+/**
+ * \brief Devices of the commutator by their local id.
+ * Devices may be added and removed at any time. A device keeps its local id
+ * while it is registered, and the ids of removed devices are not given out
+ * again, so a client never reaches another device by a stale id. The devices
+ * are stored in a vector indexed by the id, a removed device leaves an empty
+ * slot. Each change increments the structure version, so a client may compare
+ * it with the version it got the structure for.
+ */
+class DeviceRegistry {
+ public:
+  /**
+   * \brief Register the device and assign its local id.
+   */
+  std::size_t Add(std::unique_ptr<IDevice>&& device);
+  /**
+   * \brief Remove the device, returns false if there is no such device.
+   */
+  bool Remove(std::size_t local_id);
+  IDevice* Find(std::size_t local_id) const;
+
+  /**
+   * \brief Call func(local_id, device) for each registered device.
+   */
+  template <typename Func>
+  void ForEach(Func&& func) const {
+    for (std::size_t id = 0; id < devices_.size(); ++id) {
+      if (devices_[id]) {
+        func(id, *devices_[id]);
+      }
+    }
+  }
+
+  std::size_t size() const { return count_; }
+  bool empty() const { return count_ == 0; }
+  std::uint32_t structure_version() const { return structure_version_; }
+
+ private:
+  std::vector<std::unique_ptr<IDevice>> devices_;
+  std::size_t count_{};
+  std::uint32_t structure_version_{};
+};
+}  // namespace ae
+
+#endif  // DEVICE_REGISTRY_H_
@@ -0,0 +1,110 @@
+/*
+ * Copyright 2025 Aethernet Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "device_state_cache.h"
+
+#include <utility>
+
+namespace ae {
+namespace {
+// report the statistics once per this number of lookups
+constexpr std::uint64_t kReportPeriod = 100;
+
+class CachedStateAction : public DeviceStateAction {
+ public:
+  CachedStateAction(ActionContext action_context, DeviceStateData state_data)
+      : DeviceStateAction{action_context}, state_data_{std::move(state_data)} {}
+
+  UpdateStatus Update() override { return UpdateStatus::Result(); }
+
+  DeviceStateData state_data() const override { return state_data_; }
+
+ private:
+  DeviceStateData state_data_;
+};
+}  // namespace
+
+DeviceStateCache::DeviceStateCache(ActionContext action_context,
+                                   Duration max_age)
+    : action_context_{action_context}, max_age_{max_age} {}
+
+ActionPtr<DeviceStateAction> DeviceStateCache::GetState(std::size_t index,
+                                                        IDevice& device) {
+  auto& cached = entry(index);
+  if (cached.state &&
+      (cached.sampled || ((Now() - cached.read_time) <= max_age_))) {
+    ++hit_count_;
+    CountLookup();
+    return ActionPtr<CachedStateAction>{action_context_, *cached.state};
+  }
+  if (cached.reading) {
+    ++shared_count_;
+    CountLookup();
+    return *cached.reading;
+  }
+
+  ++miss_count_;
+  CountLookup();
+  auto state_action = device.GetState();
+  cached.reading = state_action;
+  state_action->StatusEvent().Subscribe(ActionHandler{
+      OnResult{[this, index](auto const& action) {
+        auto& read = entry(index);
+        read.reading.reset();
+        read.state = action.state_data();
+        read.read_time = Now();
+      }},
+      OnError{[this, index]() { entry(index).reading.reset(); }},
+  });
+  return state_action;
+}
+
+void DeviceStateCache::Store(std::size_t index, DeviceStateData state) {
+  auto& cached = entry(index);
+  cached.state = std::move(state);
+  cached.read_time = Now();
+}
+
+void DeviceStateCache::Remove(std::size_t index) {
+  if (index < entries_.size()) {
+    entries_[index] = Entry{};
+  }
+}
+
+void DeviceStateCache::SetSampled(std::size_t index, bool sampled) {
+  entry(index).sampled = sampled;
+}
+
+DeviceStateCache::Entry& DeviceStateCache::entry(std::size_t index) {
+  if (index >= entries_.size()) {
+    entries_.resize(index + 1);
+  }
+  return entries_[index];
+}
+
+void DeviceStateCache::CountLookup() {
+  auto lookup_count = hit_count_ + shared_count_ + miss_count_;
+  if ((lookup_count % kReportPeriod) != 0) {
+    return;
+  }
+  AE_TELED_INFO(
+      "Device state cache: {} lookups, {} hits, {} shared reads, {} misses, "
+      "hit ratio {:.2f}",
+      lookup_count, hit_count_, shared_count_, miss_count_,
+      static_cast<double>(hit_count_ + shared_count_) /
+          static_cast<double>(lookup_count));
+}
+}  // namespace ae
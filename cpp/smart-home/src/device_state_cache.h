@@ -0,0 +1,82 @@
+/*
+ * Copyright 2025 Aethernet Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef DEVICE_STATE_CACHE_H_
+#define DEVICE_STATE_CACHE_H_
+
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+
+#include "aether/all.h"
+
+#include "idevice.h"
+#include "api/types.h"
+
+namespace ae {
+/**
+ * \brief Per device cache of the last read state.
+ * A state not older than max age is returned without touching the hardware,
+ * and all queries arriving while a read is in progress share that read.
+ * For a sampled device the latest stored sample is returned whatever its age,
+ * the device is read only if there is no sample yet.
+ */
+class DeviceStateCache {
+ public:
+  DeviceStateCache(ActionContext action_context, Duration max_age);
+
+  ActionPtr<DeviceStateAction> GetState(std::size_t index, IDevice& device);
+  /**
+   * \brief Store the state got from the device other way than GetState, e.g.
+   * as a command result.
+   */
+  void Store(std::size_t index, DeviceStateData state);
+  /**
+   * \brief Forget the state of the removed device.
+   */
+  void Remove(std::size_t index);
+  /**
+   * \brief Mark the device as sampled in the background.
+   */
+  void SetSampled(std::size_t index, bool sampled);
+
+  std::uint64_t hit_count() const { return hit_count_; }
+  std::uint64_t shared_count() const { return shared_count_; }
+  std::uint64_t miss_count() const { return miss_count_; }
+
+ private:
+  struct Entry {
+    std::optional<DeviceStateData> state;
+    TimePoint read_time;
+    std::optional<ActionPtr<DeviceStateAction>> reading;
+    bool sampled;
+  };
+
+  Entry& entry(std::size_t index);
+  void CountLookup();
+
+  ActionContext action_context_;
+  Duration max_age_;
+  std::vector<Entry> entries_;
+
+  std::uint64_t hit_count_{};
+  std::uint64_t shared_count_{};
+  std::uint64_t miss_count_{};
+};
+}  // namespace ae
+
+#endif  // DEVICE_STATE_CACHE_H_
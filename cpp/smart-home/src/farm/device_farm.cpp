@@ -0,0 +1,199 @@
+/*
+ * Copyright 2025 Aethernet Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "farm/device_farm.h"
+
+#include <cmath>
+#include <string>
+#include <thread>
+#include <utility>
+#include <optional>
+#include <algorithm>
+
+namespace ae {
+namespace {
+// splitmix64, small state and good enough spread for simulated values
+class FarmRandom {
+ public:
+  explicit FarmRandom(std::uint64_t seed) : state_{seed} {}
+
+  std::uint64_t Next() {
+    auto z = (state_ += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+  }
+
+  // uniform in [0, 1)
+  double NextDouble() {
+    return static_cast<double>(Next() >> 11) * 0x1.0p-53;
+  }
+
+ private:
+  std::uint64_t state_;
+};
+
+class FarmStateAction : public DeviceStateAction {
+ public:
+  FarmStateAction(ActionContext action_context, TimePoint ready_time,
+                  bool failed, DeviceStateData state_data)
+      : DeviceStateAction{action_context},
+        ready_time_{ready_time},
+        failed_{failed},
+        state_data_{std::move(state_data)} {}
+
+  UpdateStatus Update() override {
+    if (Now() < ready_time_) {
+      return UpdateStatus::Delay(ready_time_);
+    }
+    return failed_ ? UpdateStatus::Error() : UpdateStatus::Result();
+  }
+
+  DeviceStateData state_data() const override { return state_data_; }
+
+ private:
+  TimePoint ready_time_;
+  bool failed_;
+  DeviceStateData state_data_;
+};
+
+class FarmDevice : public IDevice {
+ public:
+  FarmDevice(ActionContext action_context, DeviceIoExecutor& io_executor,
+             DeviceFarmConfig const& config, std::size_t farm_index)
+      : action_context_{action_context},
+        io_executor_{&io_executor},
+        latency_{config.latency},
+        failure_rate_{config.failure_rate},
+        blocking_{config.blocking},
+        random_{config.seed ^ (farm_index * 0xD1B54A32D192ED03ULL)} {}
+
+  void SetLocalId(int id) override { local_id_ = id; }
+
+ protected:
+  ActionPtr<DeviceStateAction> MakeState(VariantData value) {
+    auto failed = random_.NextDouble() < failure_rate_;
+    auto current_time = Now();
+    auto state = DeviceStateData{};
+    state.payload = std::move(value);
+    state.timestamp = static_cast<std::int64_t>(
+        std::chrono::duration_cast<std::chrono::seconds>(
+            current_time.time_since_epoch())
+            .count());
+    if (blocking_) {
+      return ActionPtr<BlockingStateAction>{
+          action_context_, *io_executor_,
+          [latency{latency_}, failed,
+           state{std::move(state)}]() -> std::optional<DeviceStateData> {
+            std::this_thread::sleep_for(latency);
+            if (failed) {
+              return std::nullopt;
+            }
+            return state;
+          }};
+    }
+    return ActionPtr<FarmStateAction>{action_context_, current_time + latency_,
+                                      failed, std::move(state)};
+  }
+
+  ActionContext action_context_;
+  DeviceIoExecutor* io_executor_;
+  Duration latency_;
+  double failure_rate_;
+  bool blocking_;
+  FarmRandom random_;
+  int local_id_{};
+};
+
+class FarmSensor : public FarmDevice {
+ public:
+  FarmSensor(ActionContext action_context, DeviceIoExecutor& io_executor,
+             DeviceFarmConfig const& config, std::size_t farm_index)
+      : FarmDevice{action_context, io_executor, config, farm_index} {
+    // sensors start at different temperatures
+    value_ = 15.0 + (random_.NextDouble() * 10.0);
+  }
+
+  HardwareDevice description() const override {
+    auto device_type = HardwareSensor{};
+    device_type.local_id = local_id_;
+    device_type.descriptor = "Farm sensor";
+    device_type.unit = "°C";
+    return HardwareDevice{device_type};
+  }
+
+  ActionPtr<DeviceStateAction> GetState() override {
+    // changes in range -0.5 to 0.5, rounded as a real sensor reports
+    value_ += random_.NextDouble() - 0.5;
+    value_ = std::clamp(value_, -40.0, 85.0);
+    return MakeState(
+        VariantData{VariantDouble{std::round(value_ * 100.0) / 100.0}});
+  }
+
+  ActionPtr<DeviceStateAction> Execute(VariantData const&) override {
+    return GetState();
+  }
+
+ private:
+  double value_;
+};
+
+class FarmActor : public FarmDevice {
+ public:
+  using FarmDevice::FarmDevice;
+
+  HardwareDevice description() const override {
+    auto device_type = HardwareActor{};
+    device_type.local_id = local_id_;
+    device_type.descriptor = "Farm relay";
+    return HardwareDevice{device_type};
+  }
+
+  ActionPtr<DeviceStateAction> GetState() override {
+    return MakeState(VariantData{VariantBool{on_}});
+  }
+
+  ActionPtr<DeviceStateAction> Execute(VariantData const& command) override {
+    if (auto const* value = std::get_if<VariantBool>(&command); value) {
+      on_ = value->value;
+    }
+    return GetState();
+  }
+
+ private:
+  bool on_{};
+};
+}  // namespace
+
+std::vector<std::unique_ptr<IDevice>> CreateDeviceFarm(
+    ActionContext action_context, DeviceIoExecutor& io_executor,
+    DeviceFarmConfig const& config) {
+  std::vector<std::unique_ptr<IDevice>> devices;
+  devices.reserve(config.sensor_count + config.actor_count);
+  std::size_t farm_index = 0;
+  for (std::size_t i = 0; i < config.sensor_count; ++i) {
+    devices.push_back(
+        std::make_unique<FarmSensor>(action_context, io_executor, config,
+                                     farm_index++));
+  }
+  for (std::size_t i = 0; i < config.actor_count; ++i) {
+    devices.push_back(
+        std::make_unique<FarmActor>(action_context, io_executor, config,
+                                    farm_index++));
+  }
+  return devices;
+}
+}  // namespace ae
@@ -0,0 +1,57 @@
+/*
+ * Copyright 2025 Aethernet Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef FARM_DEVICE_FARM_H_
+#define FARM_DEVICE_FARM_H_
+
+#include <memory>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+#include "aether/all.h"
+
+#include "idevice.h"
+#include "device_io_executor.h"
+
+namespace ae {
+struct DeviceFarmConfig {
+  std::size_t sensor_count = 0;
+  std::size_t actor_count = 0;
+  // the same seed gives the same values and failures in the same order
+  std::uint64_t seed = 1;
+  // time each read or command takes
+  Duration latency = Duration::zero();
+  // part of the reads and commands that fail, from 0 to 1
+  double failure_rate = 0;
+  // the reads block a DeviceIoExecutor worker for the latency, as a slow bus
+  bool blocking = false;
+};
+
+/**
+ * \brief Simulated sensors and actors for load tests.
+ * Each device has its own random generator seeded from the farm seed and the
+ * device's number in the farm, so the sequence of values and failures of a
+ * device does not depend on the other devices or on the process. Sensors
+ * report a random walk temperature, actors are relays keeping the last
+ * commanded bool state.
+ */
+std::vector<std::unique_ptr<IDevice>> CreateDeviceFarm(
+    ActionContext action_context, DeviceIoExecutor& io_executor,
+    DeviceFarmConfig const& config);
+}  // namespace ae
+
+#endif  // FARM_DEVICE_FARM_H_
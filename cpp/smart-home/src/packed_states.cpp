@@ -0,0 +1,286 @@
+/*
+ * Copyright 2025 Aethernet Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "packed_states.h"
+
+#include <bit>
+#include <string>
+#include <limits>
+#include <cstdint>
+#include <cstring>
+#include <variant>
+
+namespace ae {
+namespace {
+enum class ValueTag : std::uint8_t {
+  kBool = 1,
+  kLong = 2,
+  kDouble = 3,
+  kString = 4,
+  kBytes = 5,
+};
+
+std::uint64_t ZigZag(std::int64_t value) {
+  return (static_cast<std::uint64_t>(value) << 1) ^
+         static_cast<std::uint64_t>(value >> 63);
+}
+
+std::int64_t UnZigZag(std::uint64_t value) {
+  return static_cast<std::int64_t>(value >> 1) ^
+         -static_cast<std::int64_t>(value & 1);
+}
+
+// the last values, the next record is written relative to them, the deltas are
+// computed unsigned to wrap on any input instead of overflowing
+struct PackState {
+  std::uint64_t device_id;
+  std::uint64_t timestamp;
+  std::uint64_t timestamp_delta;
+  std::uint64_t double_bits;
+  std::uint64_t long_value;
+};
+
+class Writer {
+ public:
+  explicit Writer(DataBuffer& buffer) : buffer_{&buffer} {}
+
+  void Byte(std::uint8_t value) { buffer_->push_back(value); }
+
+  void Varint(std::uint64_t value) {
+    while (value >= 0x80) {
+      buffer_->push_back(static_cast<std::uint8_t>(value | 0x80));
+      value >>= 7;
+    }
+    buffer_->push_back(static_cast<std::uint8_t>(value));
+  }
+
+  void Bytes(std::uint8_t const* data, std::size_t size) {
+    Varint(size);
+    buffer_->insert(std::end(*buffer_), data, data + size);
+  }
+
+ private:
+  DataBuffer* buffer_;
+};
+
+class Reader {
+ public:
+  explicit Reader(DataBuffer const& buffer)
+      : data_{buffer.data()}, end_{buffer.data() + buffer.size()} {}
+
+  bool Byte(std::uint8_t& value) {
+    if (data_ == end_) {
+      return false;
+    }
+    value = *data_++;
+    return true;
+  }
+
+  bool Varint(std::uint64_t& value) {
+    value = 0;
+    for (unsigned shift = 0; shift < 64; shift += 7) {
+      std::uint8_t byte{};
+      if (!Byte(byte)) {
+        return false;
+      }
+      // the 10th byte has room for the 64th bit only
+      if ((shift == 63) && ((byte & 0x7F) > 1)) {
+        return false;
+      }
+      value |= static_cast<std::uint64_t>(byte & 0x7F) << shift;
+      if ((byte & 0x80) == 0) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  bool Bytes(std::uint8_t const*& data, std::size_t& size) {
+    std::uint64_t length{};
+    if (!Varint(length) ||
+        (length > static_cast<std::uint64_t>(end_ - data_))) {
+      return false;
+    }
+    data = data_;
+    size = static_cast<std::size_t>(length);
+    data_ += size;
+    return true;
+  }
+
+ private:
+  std::uint8_t const* data_;
+  std::uint8_t const* end_;
+};
+
+void PackValue(Writer& writer, PackState& last, VariantData const& value) {
+  if (auto const* v = std::get_if<VariantBool>(&value); v) {
+    writer.Byte(static_cast<std::uint8_t>(ValueTag::kBool));
+    writer.Byte(v->value ? 1 : 0);
+  } else if (auto const* v = std::get_if<VariantLong>(&value); v) {
+    writer.Byte(static_cast<std::uint8_t>(ValueTag::kLong));
+    auto delta = static_cast<std::int64_t>(v->value - last.long_value);
+    writer.Varint(ZigZag(delta));
+    last.long_value = v->value;
+  } else if (auto const* v = std::get_if<VariantDouble>(&value); v) {
+    writer.Byte(static_cast<std::uint8_t>(ValueTag::kDouble));
+    auto bits = std::bit_cast<std::uint64_t>(v->value);
+    auto xor_bits = bits ^ last.double_bits;
+    // close values share sign, exponent and high mantissa bits, and values
+    // converted from float have the low 29 bits zero
+    auto trailing_zeros = static_cast<std::uint8_t>(
+        (xor_bits == 0) ? 64 : std::countr_zero(xor_bits));
+    writer.Byte(trailing_zeros);
+    if (xor_bits != 0) {
+      writer.Varint(xor_bits >> trailing_zeros);
+    }
+    last.double_bits = bits;
+  } else if (auto const* v = std::get_if<VariantString>(&value); v) {
+    writer.Byte(static_cast<std::uint8_t>(ValueTag::kString));
+    writer.Bytes(reinterpret_cast<std::uint8_t const*>(v->value.data()),
+                 v->value.size());
+  } else if (auto const* v = std::get_if<VariantBytes>(&value); v) {
+    writer.Byte(static_cast<std::uint8_t>(ValueTag::kBytes));
+    writer.Bytes(v->value.data(), v->value.size());
+  }
+}
+
+bool UnpackValue(Reader& reader, PackState& last, VariantData& value) {
+  std::uint8_t tag{};
+  if (!reader.Byte(tag)) {
+    return false;
+  }
+  switch (static_cast<ValueTag>(tag)) {
+    case ValueTag::kBool: {
+      std::uint8_t byte{};
+      if (!reader.Byte(byte)) {
+        return false;
+      }
+      value = VariantData{VariantBool{byte != 0}};
+      return true;
+    }
+    case ValueTag::kLong: {
+      std::uint64_t delta{};
+      if (!reader.Varint(delta)) {
+        return false;
+      }
+      last.long_value += static_cast<std::uint64_t>(UnZigZag(delta));
+      value = VariantData{VariantLong{last.long_value}};
+      return true;
+    }
+    case ValueTag::kDouble: {
+      std::uint8_t trailing_zeros{};
+      if (!reader.Byte(trailing_zeros) || (trailing_zeros > 64)) {
+        return false;
+      }
+      std::uint64_t xor_bits{};
+      if ((trailing_zeros != 64) && !reader.Varint(xor_bits)) {
+        return false;
+      }
+      if (trailing_zeros != 64) {
+        last.double_bits ^= xor_bits << trailing_zeros;
+      }
+      value =
+          VariantData{VariantDouble{std::bit_cast<double>(last.double_bits)}};
+      return true;
+    }
+    case ValueTag::kString: {
+      std::uint8_t const* data{};
+      std::size_t size{};
+      if (!reader.Bytes(data, size)) {
+        return false;
+      }
+      value = VariantData{VariantString{
+          std::string{reinterpret_cast<char const*>(data), size}}};
+      return true;
+    }
+    case ValueTag::kBytes: {
+      std::uint8_t const* data{};
+      std::size_t size{};
+      if (!reader.Bytes(data, size)) {
+        return false;
+      }
+      value = VariantData{VariantBytes{DataBuffer{data, data + size}}};
+      return true;
+    }
+  }
+  return false;
+}
+}  // namespace
+
+DataBuffer PackStates(std::vector<DeviceState> const& states) {
+  DataBuffer buffer;
+  // most records of the sampled series take 4 to 8 bytes
+  buffer.reserve(4 + states.size() * 8);
+  auto writer = Writer{buffer};
+  auto last = PackState{};
+
+  writer.Varint(states.size());
+  for (auto const& state : states) {
+    auto device_id = static_cast<std::uint64_t>(
+        static_cast<std::int64_t>(state.local_device_id));
+    writer.Varint(
+        ZigZag(static_cast<std::int64_t>(device_id - last.device_id)));
+    last.device_id = device_id;
+
+    auto timestamp = static_cast<std::uint64_t>(state.state.timestamp);
+    auto delta = timestamp - last.timestamp;
+    writer.Varint(
+        ZigZag(static_cast<std::int64_t>(delta - last.timestamp_delta)));
+    last.timestamp = timestamp;
+    last.timestamp_delta = delta;
+
+    PackValue(writer, last, state.state.payload);
+  }
+  return buffer;
+}
+
+std::optional<std::vector<DeviceState>> UnpackStates(DataBuffer const& data) {
+  auto reader = Reader{data};
+  auto last = PackState{};
+
+  std::uint64_t count{};
+  // each record takes at least 3 bytes
+  if (!reader.Varint(count) || (count > data.size() / 3)) {
+    return std::nullopt;
+  }
+  std::vector<DeviceState> states;
+  states.reserve(static_cast<std::size_t>(count));
+  for (std::uint64_t i = 0; i < count; ++i) {
+    std::uint64_t id_delta{};
+    std::uint64_t delta_of_delta{};
+    if (!reader.Varint(id_delta) || !reader.Varint(delta_of_delta)) {
+      return std::nullopt;
+    }
+    last.device_id += static_cast<std::uint64_t>(UnZigZag(id_delta));
+    last.timestamp_delta +=
+        static_cast<std::uint64_t>(UnZigZag(delta_of_delta));
+    last.timestamp += last.timestamp_delta;
+    auto device_id = static_cast<std::int64_t>(last.device_id);
+    if ((device_id < std::numeric_limits<int>::min()) ||
+        (device_id > std::numeric_limits<int>::max())) {
+      return std::nullopt;
+    }
+
+    auto& state = states.emplace_back();
+    state.local_device_id = static_cast<int>(device_id);
+    state.state.timestamp = static_cast<std::int64_t>(last.timestamp);
+    if (!UnpackValue(reader, last, state.state.payload)) {
+      return std::nullopt;
+    }
+  }
+  return states;
+}
+}  // namespace ae
@@ -0,0 +1,48 @@
+/*
+ * Copyright 2025 Aethernet Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef PACKED_STATES_H_
+#define PACKED_STATES_H_
+
+#include <vector>
+#include <optional>
+
+#include "aether/all.h"
+
+#include "api/types.h"
+
+namespace ae {
+/**
+ * \brief Compact encoding of a sequence of device states.
+ * The sequence is written as a varint count followed by the records. Each
+ * record has the zigzag varint delta of the device id, the zigzag varint
+ * delta-of-delta of the timestamp, the variant index byte and the value:
+ * a double is XOR-ed with the previous double and written as the number of
+ * trailing zero bits and the varint of the rest, an integer as the zigzag
+ * varint delta from the previous integer, a bool as a byte, strings and bytes
+ * as varint length and the data. Regular series of slowly changing values, as
+ * sampled sensors produce, take a few bytes per state. The encoding is
+ * lossless.
+ */
+DataBuffer PackStates(std::vector<DeviceState> const& states);
+
+/**
+ * \brief Decode PackStates result, std::nullopt on malformed data.
+ */
+std::optional<std::vector<DeviceState>> UnpackStates(DataBuffer const& data);
+}  // namespace ae
+
+#endif  // PACKED_STATES_H_
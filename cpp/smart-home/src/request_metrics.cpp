@@ -0,0 +1,112 @@
+/*
+ * Copyright 2025 Aethernet Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "request_metrics.h"
+
+#include <limits>
+#include <algorithm>
+
+namespace ae {
+namespace {
+constexpr auto kReportInterval = std::chrono::minutes{1};
+}  // namespace
+
+RequestMetrics::RequestMetrics()
+    : start_time_{Now()}, next_report_time_{start_time_ + kReportInterval} {}
+
+void RequestMetrics::Begin() {
+  ++in_flight_;
+  max_in_flight_ = std::max(max_in_flight_, in_flight_);
+}
+
+void RequestMetrics::Record(std::uint8_t method_id, TimePoint request_time,
+                            bool success) {
+  if (in_flight_ != 0) {
+    --in_flight_;
+  }
+  if (method_id >= kMethodCount) {
+    return;
+  }
+  auto latency_us = static_cast<std::uint64_t>(
+      std::chrono::duration_cast<std::chrono::microseconds>(Now() -
+                                                            request_time)
+          .count());
+  auto& method = methods_[method_id];
+  ++method.count;
+  if (!success) {
+    ++method.error_count;
+  }
+  method.latency_sum_us += latency_us;
+  method.max_latency_us = static_cast<std::uint32_t>(
+      std::min<std::uint64_t>(std::max<std::uint64_t>(method.max_latency_us,
+                                                       latency_us),
+                              std::numeric_limits<std::uint32_t>::max()));
+  ++method.histogram[BucketIndex(latency_us)];
+}
+
+void RequestMetrics::Snapshot(TimePoint current_time,
+                              CommutatorMetrics& metrics) const {
+  metrics.uptime = static_cast<std::uint32_t>(
+      std::chrono::duration_cast<std::chrono::seconds>(current_time -
+                                                       start_time_)
+          .count());
+  metrics.in_flight = in_flight_;
+  metrics.max_in_flight = max_in_flight_;
+  metrics.latency_bounds_ms.assign(std::begin(kLatencyBoundsMs),
+                                   std::end(kLatencyBoundsMs));
+  metrics.methods.clear();
+  for (std::size_t id = 0; id < methods_.size(); ++id) {
+    auto const& method = methods_[id];
+    if (method.count == 0) {
+      continue;
+    }
+    metrics.methods.push_back(MethodMetrics{
+        static_cast<std::uint8_t>(id), method.count, method.error_count,
+        method.latency_sum_us, method.max_latency_us,
+        std::vector<std::uint32_t>(std::begin(method.histogram),
+                                   std::end(method.histogram))});
+  }
+}
+
+TimePoint RequestMetrics::Update(TimePoint current_time) {
+  if (current_time < next_report_time_) {
+    return next_report_time_;
+  }
+  next_report_time_ = current_time + kReportInterval;
+  AE_TELED_INFO("Requests: {} in flight, {} at most", in_flight_,
+                max_in_flight_);
+  for (std::size_t id = 0; id < methods_.size(); ++id) {
+    auto const& method = methods_[id];
+    if (method.count == 0) {
+      continue;
+    }
+    AE_TELED_INFO(
+        "Method {}: {} requests, {} errors, latency avg {} us, max {} us", id,
+        method.count, method.error_count,
+        method.latency_sum_us / method.count, method.max_latency_us);
+  }
+  return next_report_time_;
+}
+
+std::size_t RequestMetrics::BucketIndex(std::uint64_t latency_us) {
+  auto bound = std::lower_bound(std::begin(kLatencyBoundsMs),
+                                std::end(kLatencyBoundsMs), latency_us,
+                                [](std::uint32_t bound_ms, std::uint64_t us) {
+                                  return std::uint64_t{bound_ms} * 1000 < us;
+                                });
+  return static_cast<std::size_t>(bound - std::begin(kLatencyBoundsMs));
+}
+}  // namespace ae
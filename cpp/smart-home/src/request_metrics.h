@@ -0,0 +1,88 @@
+/*
+ * Copyright 2025 Aethernet Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef REQUEST_METRICS_H_
+#define REQUEST_METRICS_H_
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include "aether/all.h"
+
+#include "api/types.h"
+
+namespace ae {
+/**
+ * \brief Counts, latency histograms and in-flight number of the commutator's
+ * requests per API method.
+ * Each Begin must be followed by one Record for the same request, when it is
+ * answered or has failed. Snapshot is sent to the clients by GetMetrics and a
+ * summary is written to the telemetry log periodically, so a slow commutator
+ * and its slow methods can be seen remotely.
+ */
+class RequestMetrics {
+ public:
+  // method ids are the RegMethod ids, all below this
+  static constexpr std::size_t kMethodCount = 16;
+  // upper bounds of the latency histogram buckets, the last bucket has none
+  static constexpr std::array<std::uint32_t, 11> kLatencyBoundsMs{
+      1, 2, 5, 10, 20, 50, 100, 200, 500, 1000, 2000};
+
+  RequestMetrics();
+
+  /**
+   * \brief A request is parsed.
+   */
+  void Begin();
+  /**
+   * \brief The request begun at request_time is answered or has failed.
+   */
+  void Record(std::uint8_t method_id, TimePoint request_time, bool success);
+
+  /**
+   * \brief Fill the request metrics of the snapshot.
+   */
+  void Snapshot(TimePoint current_time, CommutatorMetrics& metrics) const;
+
+  /**
+   * \brief Write the summary to the telemetry log when it's time.
+   * Returns the time it should be called next.
+   */
+  TimePoint Update(TimePoint current_time);
+
+ private:
+  static constexpr std::size_t kBucketCount = kLatencyBoundsMs.size() + 1;
+
+  struct Method {
+    std::uint32_t count;
+    std::uint32_t error_count;
+    std::uint64_t latency_sum_us;
+    std::uint32_t max_latency_us;
+    std::array<std::uint32_t, kBucketCount> histogram;
+  };
+
+  static std::size_t BucketIndex(std::uint64_t latency_us);
+
+  TimePoint start_time_;
+  TimePoint next_report_time_;
+  std::array<Method, kMethodCount> methods_{};
+  std::uint32_t in_flight_{};
+  std::uint32_t max_in_flight_{};
+};
+}  // namespace ae
+
+#endif  // REQUEST_METRICS_H_
@@ -0,0 +1,112 @@
+/*
+ * Copyright 2025 Aethernet Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "sampling_scheduler.h"
+
+#include <algorithm>
+
+namespace ae {
+namespace {
+// how long Update may sleep without sampled devices
+constexpr auto kIdleUpdateInterval = std::chrono::seconds{60};
+}  // namespace
+
+SamplingScheduler::SamplingScheduler(DeviceRegistry const& devices)
+    : devices_{&devices} {}
+
+void SamplingScheduler::SetPeriod(std::size_t local_id, Duration period) {
+  if (period == Duration::zero()) {
+    if (local_id < sampled_.size()) {
+      // the scheduled read of the stopped device is skipped by Update
+      sampled_[local_id].reset();
+    }
+    return;
+  }
+  if (local_id >= sampled_.size()) {
+    sampled_.resize(local_id + 1);
+  }
+  auto& sampled = sampled_[local_id];
+  if (!sampled) {
+    sampled = std::make_unique<Sampled>();
+  }
+  sampled->period = period;
+  // read right away, the first sample should not wait for a whole period
+  sampled->next_time = Now();
+  schedule_.emplace(sampled->next_time, local_id);
+}
+
+bool SamplingScheduler::IsSampled(std::size_t local_id) const {
+  return (local_id < sampled_.size()) && sampled_[local_id];
+}
+
+TimePoint SamplingScheduler::Update(TimePoint current_time) {
+  while (!schedule_.empty() && (schedule_.top().first <= current_time)) {
+    auto [time, local_id] = schedule_.top();
+    schedule_.pop();
+    auto* sampled =
+        (local_id < sampled_.size()) ? sampled_[local_id].get() : nullptr;
+    // stale item of a stopped or rescheduled device
+    if ((sampled == nullptr) || (sampled->next_time != time)) {
+      continue;
+    }
+    sampled->next_time = std::max(time + sampled->period, current_time);
+    schedule_.emplace(sampled->next_time, local_id);
+    // a sensor slower than its period is read as often as it can be
+    if (!sampled->reading) {
+      Read(local_id, *sampled);
+    }
+  }
+  return schedule_.empty() ? current_time + kIdleUpdateInterval
+                           : schedule_.top().first;
+}
+
+void SamplingScheduler::Read(std::size_t local_id, Sampled& sampled) {
+  auto* device = devices_->Find(local_id);
+  if (device == nullptr) {
+    sampled_[local_id].reset();
+    return;
+  }
+  sampled.reading = true;
+  auto state_action = device->GetState();
+  state_action->StatusEvent().Subscribe(ActionHandler{
+      OnResult{[this, local_id](auto const& action) {
+        SampleRead(local_id, action.state_data());
+      }},
+      OnError{[this, local_id]() {
+        if (IsSampled(local_id)) {
+          sampled_[local_id]->reading = false;
+        }
+      }},
+  });
+}
+
+void SamplingScheduler::SampleRead(std::size_t local_id,
+                                   DeviceStateData state) {
+  if (!IsSampled(local_id)) {
+    return;
+  }
+  auto& sampled = *sampled_[local_id];
+  sampled.reading = false;
+  if (sampled.buffer.size() >= kBufferSize) {
+    ++overflow_count_;
+    AE_TELED_INFO("Sample of device {} dropped, {} dropped in total", local_id,
+                  overflow_count_);
+    return;
+  }
+  sampled.buffer.push_back(std::move(state));
+  ++pending_count_;
+}
+}  // namespace ae
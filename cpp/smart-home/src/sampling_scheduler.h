@@ -0,0 +1,112 @@
+/*
+ * Copyright 2025 Aethernet Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef SAMPLING_SCHEDULER_H_
+#define SAMPLING_SCHEDULER_H_
+
+#include <deque>
+#include <queue>
+#include <memory>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <functional>
+
+#include "aether/all.h"
+
+#include "idevice.h"
+#include "api/types.h"
+#include "device_registry.h"
+
+namespace ae {
+/**
+ * \brief Reads the devices in the background, each one with its own period.
+ * The read states are queued per device and taken out by Drain, so the request
+ * path gets the latest sample without waiting for the sensor, and a slow
+ * sensor does not delay the others. The reads complete on the application
+ * loop, as Drain is called. Devices without a sampling period are not read.
+ */
+class SamplingScheduler {
+ public:
+  // samples kept per device until the next Drain
+  static constexpr std::size_t kBufferSize = 8;
+
+  explicit SamplingScheduler(DeviceRegistry const& devices);
+
+  /**
+   * \brief Read the device each period, a zero period stops the sampling.
+   */
+  void SetPeriod(std::size_t local_id, Duration period);
+  bool IsSampled(std::size_t local_id) const;
+
+  /**
+   * \brief Start the reads that are due.
+   * Must be called on each application loop iteration.
+   * Returns the time it should be called next.
+   */
+  TimePoint Update(TimePoint current_time);
+
+  /**
+   * \brief Call func(local_id, state) for each sample in arrival order per
+   * device.
+   */
+  template <typename Func>
+  void Drain(Func&& func) {
+    if (pending_count_ == 0) {
+      return;
+    }
+    pending_count_ = 0;
+    for (std::size_t id = 0; id < sampled_.size(); ++id) {
+      if (!sampled_[id]) {
+        continue;
+      }
+      auto& buffer = sampled_[id]->buffer;
+      while (!buffer.empty()) {
+        auto sample = std::move(buffer.front());
+        buffer.pop_front();
+        func(id, std::move(sample));
+      }
+    }
+  }
+
+  std::uint64_t overflow_count() const { return overflow_count_; }
+
+ private:
+  struct Sampled {
+    Duration period;
+    TimePoint next_time;
+    bool reading;
+    std::deque<DeviceStateData> buffer;
+  };
+  using ScheduleItem = std::pair<TimePoint, std::size_t>;
+
+  void Read(std::size_t local_id, Sampled& sampled);
+  void SampleRead(std::size_t local_id, DeviceStateData state);
+
+  DeviceRegistry const* devices_;
+  // indexed by local id, empty for the devices not sampled
+  std::vector<std::unique_ptr<Sampled>> sampled_;
+  std::priority_queue<ScheduleItem, std::vector<ScheduleItem>,
+                      std::greater<ScheduleItem>>
+      schedule_;
+  // samples buffered since the last Drain
+  std::size_t pending_count_{};
+  std::uint64_t overflow_count_{};
+};
+}  // namespace ae
+
+#endif  // SAMPLING_SCHEDULER_H_
@@ -19,6 +19,8 @@
 #include "aether/all.h"
 
 #include "commutator.h"
+#include "device_io_executor.h"
+#include "farm/device_farm.h"
 #include "temperature/temperature_factory.h"
 
 #if defined ESP_PLATFORM
@@ -35,6 +37,36 @@
 
 static constexpr auto kParentUid =
     ae::Uid::FromString("3ac93165-3d37-4970-87a6-fa4ee27744e4");
+// the temperature is read in the background, queries get the latest sample
+static constexpr auto kTempSensorSamplingPeriod = std::chrono::seconds{1};
+
+// simulated devices for load tests, set by cmake on desktop
+#if !defined DEVICE_FARM_SENSORS
+#  define DEVICE_FARM_SENSORS 0
+#endif
+#if !defined DEVICE_FARM_ACTORS
+#  define DEVICE_FARM_ACTORS 0
+#endif
+#if !defined DEVICE_FARM_SEED
+#  define DEVICE_FARM_SEED 1
+#endif
+#if !defined DEVICE_FARM_LATENCY_MS
+#  define DEVICE_FARM_LATENCY_MS 0
+#endif
+#if !defined DEVICE_FARM_FAILURE_RATE
+#  define DEVICE_FARM_FAILURE_RATE 0
+#endif
+#if !defined DEVICE_FARM_BLOCKING
+#  define DEVICE_FARM_BLOCKING 0
+#endif
+
+static ae::DeviceFarmConfig const kDeviceFarmConfig{
+    DEVICE_FARM_SENSORS,
+    DEVICE_FARM_ACTORS,
+    DEVICE_FARM_SEED,
+    std::chrono::milliseconds{DEVICE_FARM_LATENCY_MS},
+    DEVICE_FARM_FAILURE_RATE,
+    DEVICE_FARM_BLOCKING != 0};
 
 int SmartHomeMain() {
   /**
@@ -47,6 +79,8 @@ int SmartHomeMain() {
    */
   auto aether_app = ae::construct_aether_app();
 
+  // blocking device reads run here, off the application loop
+  ae::DeviceIoExecutor io_executor;
   std::unique_ptr<ae::Commutator> commutator;
 
   // load or register new client for smart home
@@ -69,7 +103,8 @@ REGISTERED CLIENT'S UID: {}
 
         )",
               smart_home_client->uid());
-          commutator = std::make_unique<ae::Commutator>(smart_home_client);
+          commutator = std::make_unique<ae::Commutator>(*aether_app,
+                                                        smart_home_client);
 // add sensors to commutator
 #if defined ESP_PLATFORM && ESP32_HAS_TEMP_SENSOR
           auto temp_sensor_config =
@@ -79,8 +114,17 @@ REGISTERED CLIENT'S UID: {}
           auto temp_sensor_config =
               ae::TempSensorConfig{ae::TempSensorType::kFakeTempSensor};
 #endif
-          commutator->AddDevice(ae::TemperatureFactory::CreateDevice(
-              *aether_app, &temp_sensor_config));
+          auto temp_sensor_id =
+              commutator->AddDevice(ae::TemperatureFactory::CreateDevice(
+                  *aether_app, io_executor, &temp_sensor_config));
+          commutator->SetSamplingPeriod(temp_sensor_id,
+                                        kTempSensorSamplingPeriod);
+
+          for (auto& device :
+               ae::CreateDeviceFarm(*aether_app, io_executor,
+                                    kDeviceFarmConfig)) {
+            commutator->AddDevice(std::move(device));
+          }
         } else {
           aether_app->Exit(1);
         }
@@ -95,7 +139,12 @@ REGISTERED CLIENT'S UID: {}
   while (!aether_app->IsExited()) {
     // Wait for next event or timeout
     auto current_time = ae::Now();
-    auto next_time = aether_app->Update(current_time);
+    // the device reads' completions trigger the actions updated next
+    auto next_time = io_executor.Update(current_time);
+    next_time = std::min(next_time, aether_app->Update(current_time));
+    if (commutator) {
+      next_time = std::min(next_time, commutator->Update(current_time));
+    }
     aether_app->WaitUntil(
         std::min(next_time, current_time + std::chrono::seconds{5}));
   }
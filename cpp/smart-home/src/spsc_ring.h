@@ -0,0 +1,71 @@
+/*
+ * Copyright 2025 Aethernet Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef SPSC_RING_H_
+#define SPSC_RING_H_
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <utility>
+#include <optional>
+
+namespace ae {
+/**
+ * \brief Fixed size lock-free queue for one producer and one consumer.
+ * Push may be called from one thread and Pop from another one without locks.
+ * Size must be a power of two.
+ */
+template <typename T, std::size_t Size>
+class SpscRing {
+  static_assert((Size != 0) && ((Size & (Size - 1)) == 0),
+                "Size must be a power of two");
+
+ public:
+  /**
+   * \brief Producer side, returns false if the ring is full.
+   */
+  bool Push(T value) {
+    auto head = head_.load(std::memory_order_relaxed);
+    if (head - tail_.load(std::memory_order_acquire) == Size) {
+      return false;
+    }
+    slots_[head & (Size - 1)] = std::move(value);
+    head_.store(head + 1, std::memory_order_release);
+    return true;
+  }
+
+  /**
+   * \brief Consumer side, returns std::nullopt if the ring is empty.
+   */
+  std::optional<T> Pop() {
+    auto tail = tail_.load(std::memory_order_relaxed);
+    if (tail == head_.load(std::memory_order_acquire)) {
+      return std::nullopt;
+    }
+    auto value = std::move(slots_[tail & (Size - 1)]);
+    tail_.store(tail + 1, std::memory_order_release);
+    return value;
+  }
+
+ private:
+  std::array<T, Size> slots_{};
+  std::atomic<std::size_t> head_{0};
+  std::atomic<std::size_t> tail_{0};
+};
+}  // namespace ae
+
+#endif  // SPSC_RING_H_
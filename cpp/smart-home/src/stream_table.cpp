@@ -0,0 +1,125 @@
+/*
+ * Copyright 2025 Aethernet Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "stream_table.h"
+
+#include <cassert>
+#include <utility>
+#include <algorithm>
+
+namespace ae {
+StreamTable::StreamTable(std::size_t max_count, Duration idle_timeout,
+                         RemovedCallback on_removed)
+    : max_count_{max_count},
+      idle_timeout_{idle_timeout},
+      on_removed_{std::move(on_removed)} {
+  assert((max_count_ > 0) && "Stream table must fit at least one stream");
+  entries_.reserve(max_count_);
+}
+
+void StreamTable::Add(Uid const& uid, RcPtr<P2pStream> stream,
+                      std::unique_ptr<CommutatorApiImpl> api_impl,
+                      Subscription message_sub, TimePoint current_time) {
+  if (auto* entry = Find(uid); entry != nullptr) {
+    // the client has opened a new stream, it keeps everything else
+    entry->message_sub = std::move(message_sub);
+    if (api_impl) {
+      entry->api_impl = std::move(api_impl);
+    }
+    entry->stream = std::move(stream);
+    entry->last_activity = current_time;
+    return;
+  }
+  if (entries_.size() >= max_count_) {
+    // the subscribed streams go last, the least recently active first
+    auto lru = std::min_element(
+        std::begin(entries_), std::end(entries_),
+        [](auto const& left, auto const& right) {
+          if (left.subscribed != right.subscribed) {
+            return right.subscribed;
+          }
+          return left.last_activity < right.last_activity;
+        });
+    Remove(static_cast<std::size_t>(lru - std::begin(entries_)));
+  }
+  entries_.push_back(Entry{uid, std::move(stream), std::move(api_impl),
+                           std::move(message_sub), current_time});
+}
+
+StreamTable::Entry* StreamTable::Find(Uid const& uid) {
+  auto it = std::find_if(std::begin(entries_), std::end(entries_),
+                         [&](auto const& entry) { return entry.uid == uid; });
+  return (it != std::end(entries_)) ? &*it : nullptr;
+}
+
+bool StreamTable::Remove(Uid const& uid) {
+  auto it = std::find_if(std::begin(entries_), std::end(entries_),
+                         [&](auto const& entry) { return entry.uid == uid; });
+  if (it == std::end(entries_)) {
+    return false;
+  }
+  Remove(static_cast<std::size_t>(it - std::begin(entries_)));
+  return true;
+}
+
+void StreamTable::Touch(Uid const& uid, TimePoint current_time) {
+  if (auto* entry = Find(uid); entry != nullptr) {
+    entry->last_activity = current_time;
+  }
+}
+
+void StreamTable::SetSubscribed(Uid const& uid, bool subscribed,
+                                TimePoint current_time) {
+  auto* entry = Find(uid);
+  if ((entry == nullptr) || (entry->subscribed == subscribed)) {
+    return;
+  }
+  entry->subscribed = subscribed;
+  if (!subscribed) {
+    entry->last_activity = current_time;
+  }
+}
+
+TimePoint StreamTable::RemoveIdle(TimePoint current_time) {
+  auto next_idle_time = current_time + idle_timeout_;
+  for (std::size_t i = 0; i < entries_.size();) {
+    if (entries_[i].subscribed) {
+      ++i;
+      continue;
+    }
+    auto idle_time = entries_[i].last_activity + idle_timeout_;
+    if (idle_time <= current_time) {
+      // the last entry is moved to i, check it on the same index
+      Remove(i);
+      continue;
+    }
+    next_idle_time = std::min(next_idle_time, idle_time);
+    ++i;
+  }
+  return next_idle_time;
+}
+
+void StreamTable::Remove(std::size_t index) {
+  auto uid = entries_[index].uid;
+  if (index != entries_.size() - 1) {
+    std::swap(entries_[index], entries_.back());
+  }
+  entries_.pop_back();
+  if (on_removed_) {
+    on_removed_(uid);
+  }
+}
+}  // namespace ae
@@ -0,0 +1,101 @@
+/*
+ * Copyright 2025 Aethernet Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef STREAM_TABLE_H_
+#define STREAM_TABLE_H_
+
+#include <memory>
+#include <vector>
+#include <cstddef>
+#include <functional>
+
+#include "aether/all.h"
+
+#include "commutator_api_impl.h"
+
+namespace ae {
+/**
+ * \brief Client streams of the commutator with bounded memory.
+ * Entries are kept in one flat vector, so a lookup is a linear scan over
+ * contiguous memory, which beats a tree for the tens of clients a commutator
+ * serves. A stream without incoming messages for the idle timeout is removed,
+ * and when the table is full the least recently active stream makes room for
+ * the new one. Streams with state subscriptions only receive pushes, so they
+ * are never idle and make room only if every stream in the table is
+ * subscribed. Removing an entry also drops its message subscription and
+ * requests dispatcher, and on_removed is called to clean up anything else kept
+ * for the client.
+ */
+class StreamTable {
+ public:
+  struct Entry {
+    Uid uid;
+    // empty for the streams owned by the commutator's user
+    RcPtr<P2pStream> stream;
+    std::unique_ptr<CommutatorApiImpl> api_impl;
+    // declared after api_impl to be destroyed before it
+    Subscription message_sub;
+    TimePoint last_activity;
+    bool subscribed{};
+  };
+
+  using RemovedCallback = std::function<void(Uid const& uid)>;
+
+  StreamTable(std::size_t max_count, Duration idle_timeout,
+              RemovedCallback on_removed);
+
+  /**
+   * \brief Add the stream, or replace the stream of the same client.
+   * The client's dispatcher is kept if api_impl is null, so the pointers to it
+   * stay valid as long as the client is in the table.
+   */
+  void Add(Uid const& uid, RcPtr<P2pStream> stream,
+           std::unique_ptr<CommutatorApiImpl> api_impl,
+           Subscription message_sub, TimePoint current_time);
+  Entry* Find(Uid const& uid);
+  /**
+   * \brief Remove the client's stream, returns false if it is not in the
+   * table.
+   */
+  bool Remove(Uid const& uid);
+  /**
+   * \brief Mark the client's stream as active.
+   */
+  void Touch(Uid const& uid, TimePoint current_time);
+  /**
+   * \brief Mark whether the client has state subscriptions.
+   * A stream losing its last subscription counts as active at current_time.
+   */
+  void SetSubscribed(Uid const& uid, bool subscribed, TimePoint current_time);
+  /**
+   * \brief Remove the idle streams.
+   * Returns the time the next stream becomes idle.
+   */
+  TimePoint RemoveIdle(TimePoint current_time);
+
+  std::size_t size() const { return entries_.size(); }
+
+ private:
+  void Remove(std::size_t index);
+
+  std::size_t max_count_;
+  Duration idle_timeout_;
+  RemovedCallback on_removed_;
+  std::vector<Entry> entries_;
+};
+}  // namespace ae
+
+#endif  // STREAM_TABLE_H_
@@ -19,29 +19,15 @@
 #if ESP32_HAS_TEMP_SENSOR
 
 #  include <chrono>
+#  include <optional>
 
 namespace ae {
-class EspTempDataStateAction : public DeviceStateAction {
- public:
-  EspTempDataStateAction(ActionContext action_context, float value)
-      : DeviceStateAction{action_context}, state_data_{} {
-    state_data_.payload = VariantData{VariantDouble{value}};
-    state_data_.timestamp = static_cast<std::int64_t>(
-        std::chrono::duration_cast<std::chrono::seconds>(
-            Now().time_since_epoch())
-            .count());
-  }
-
-  UpdateStatus Update() override { return UpdateStatus::Result(); }
-
-  DeviceStateData state_data() const override { return state_data_; }
-
-  DeviceStateData state_data_;
-};
-
 EspTempSensor::EspTempSensor(ActionContext action_context,
+                             DeviceIoExecutor& io_executor,
                              temperature_sensor_config_t temp_sensor_config)
-    : action_context_{action_context}, temp_sensor_config_{temp_sensor_config} {
+    : action_context_{action_context},
+      io_executor_{&io_executor},
+      temp_sensor_config_{temp_sensor_config} {
   StartSensor();
 }
 
@@ -58,22 +44,30 @@ HardwareDevice EspTempSensor::description() const {
 }
 
 ActionPtr<DeviceStateAction> EspTempSensor::GetState() {
-  return ActionPtr<EspTempDataStateAction>{action_context_, GetTemperature()};
+  // the sensor is read on the device I/O task, not to stall the network
+  return ActionPtr<BlockingStateAction>{
+      action_context_, *io_executor_,
+      [temp_sensor{temp_sensor_}]() -> std::optional<DeviceStateData> {
+        float tsens_value{};
+        if ((temp_sensor == nullptr) ||
+            (temperature_sensor_get_celsius(temp_sensor, &tsens_value) !=
+             ESP_OK)) {
+          return std::nullopt;
+        }
+        auto state_data = DeviceStateData{};
+        state_data.payload = VariantData{VariantDouble{tsens_value}};
+        state_data.timestamp = static_cast<std::int64_t>(
+            std::chrono::duration_cast<std::chrono::seconds>(
+                Now().time_since_epoch())
+                .count());
+        return state_data;
+      }};
 }
 
 ActionPtr<DeviceStateAction> EspTempSensor::Execute(VariantData const&) {
   return GetState();
 }
 
-float EspTempSensor::GetTemperature() {
-  float tsens_value = -1000;
-  if (temp_sensor_ != nullptr) {
-    ESP_ERROR_CHECK(temperature_sensor_get_celsius(temp_sensor_, &tsens_value));
-  }
-
-  return tsens_value;
-}
-
 void EspTempSensor::StartSensor() {
   ESP_ERROR_CHECK(
       temperature_sensor_install(&temp_sensor_config_, &temp_sensor_));
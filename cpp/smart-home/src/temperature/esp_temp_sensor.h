@@ -34,11 +34,12 @@
 
 #    include "idevice.h"
 #    include "api/types.h"
+#    include "device_io_executor.h"
 
 namespace ae {
 class EspTempSensor : public IDevice {
  public:
-  EspTempSensor(ActionContext action_context,
+  EspTempSensor(ActionContext action_context, DeviceIoExecutor& io_executor,
                 temperature_sensor_config_t temp_sensor_config);
   ~EspTempSensor() override;
 
@@ -50,13 +51,12 @@ class EspTempSensor : public IDevice {
 
   ActionPtr<DeviceStateAction> Execute(VariantData const& command) override;
 
-  float GetTemperature();
-
  private:
   void StartSensor();
   void StopSensor();
 
   ActionContext action_context_;
+  DeviceIoExecutor* io_executor_;
   int local_id_{};
   temperature_sensor_handle_t temp_sensor_ = nullptr;
   temperature_sensor_config_t temp_sensor_config_;
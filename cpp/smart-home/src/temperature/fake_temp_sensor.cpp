@@ -16,7 +16,6 @@
 
 #include "temperature/fake_temp_sensor.h"
 
-#include <cstdlib>
 #include <algorithm>
 
 namespace ae {
@@ -41,7 +40,11 @@ class FakeTempSensorDataStateAction : public DeviceStateAction {
 FakeTempSensor::FakeTempSensor(ActionContext action_context)
     : actio_context_{action_context} {}
 
-void FakeTempSensor::SetLocalId(int id) { local_id_ = id; }
+void FakeTempSensor::SetLocalId(int id) {
+  local_id_ = id;
+  // the same device gets the same sequence of values in each run
+  random_.seed(static_cast<std::minstd_rand::result_type>(id) + 1);
+}
 
 HardwareDevice FakeTempSensor::description() const {
   auto device_type = HardwareSensor{};
@@ -60,13 +63,8 @@ ActionPtr<DeviceStateAction> FakeTempSensor::Execute(VariantData const&) {
 }
 
 float FakeTempSensor::Read() {
-  // randomly generate a new value change
-  static bool const seed =
-      (std::srand(static_cast<unsigned int>(time(nullptr))), true);
-  (void)seed;
-
   // value changes in range -2 to 2
-  float value = (static_cast<float>(std::rand() % 4000) - 2000) / 1000;
+  float value = (static_cast<float>(random_() % 4000) - 2000) / 1000;
   old_value_ += value;
   old_value_ = std::clamp(old_value_, -100.0F, 100.0F);
   return old_value_;
@@ -17,6 +17,8 @@
 #ifndef TEMPERATURE_FAKE_TEMP_SENSOR_H_
 #define TEMPERATURE_FAKE_TEMP_SENSOR_H_
 
+#include <random>
+
 #include "aether/all.h"
 
 #include "idevice.h"
@@ -38,6 +40,8 @@ class FakeTempSensor : public IDevice {
   ActionContext actio_context_;
   int local_id_{};
   float old_value_{18.F};
+  // own generator, values of a sensor don't depend on the other sensors
+  std::minstd_rand random_;
 };
 }  // namespace ae
 
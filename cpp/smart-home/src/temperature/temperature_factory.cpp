@@ -23,13 +23,14 @@
 
 namespace ae {
 std::unique_ptr<IDevice> TemperatureFactory::CreateDevice(
-    [[maybe_unused]] ActionContext action_context, TempSensorConfig* config) {
+    [[maybe_unused]] ActionContext action_context,
+    [[maybe_unused]] DeviceIoExecutor& io_executor, TempSensorConfig* config) {
   switch (config->type) {
     case TempSensorType::kEspTempSensor:
 #if defined ESP_PLATFORM && ESP32_HAS_TEMP_SENSOR
     {
       auto* esp_config = reinterpret_cast<EspTempSensorConfig*>(config);
-      return std::make_unique<EspTempSensor>(action_context,
+      return std::make_unique<EspTempSensor>(action_context, io_executor,
                                              esp_config->config);
     }
 #else
@@ -20,6 +20,7 @@
 #include <memory>
 
 #include "idevice.h"
+#include "device_io_executor.h"
 #include "temperature/temp_sensor_config.h"
 
 namespace ae {
@@ -27,6 +28,7 @@ namespace ae {
 class TemperatureFactory {
  public:
   static std::unique_ptr<IDevice> CreateDevice(ActionContext action_context,
+                                               DeviceIoExecutor& io_executor,
                                                TempSensorConfig* config);
 };
 }  // namespace ae
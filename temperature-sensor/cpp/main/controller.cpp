@@ -37,6 +37,8 @@ static const char *TAG_MAIN = "BME68X";
 // include Aether lib
 #include "aether/all.h"
 
+#include "async_logger.h"
+
 #if BOARD_HAS_ULP == 1
 #  include <ulp_lp_core.h>
 #  include <lp_core_i2c.h>
@@ -194,6 +196,8 @@ void loop() {
   } else {
     context.streams.clear();
     context.aether_app.Reset();
+    // the log would be lost in deep sleep
+    Logger().Flush();
     lp_goto_sleep();
   }
 }
@@ -249,7 +253,8 @@ void UpdateRead() {
   auto delta = time - context.last_update_time;
 
   auto value = ReadTemperature();
-  std::cout << ">> Temperature: " << value << "°C\n\n";
+  Logger().Log(
+      [value]() { return ae::Format(">> Temperature: {}°C\n\n", value); });
   // the last value is first value
   context.records.push_front(Record{
       value,
@@ -274,12 +279,12 @@ void RemoveStreams() {
 #if BOARD_HAS_ULP == 1
 float ReadTemperature() {
   if (cause == ESP_SLEEP_WAKEUP_ULP) {
-    std::cout << ">> ULP " << "\n";
+    Logger().Log([]() { return std::string{">> ULP \n"}; });
     float value = static_cast<float>(ulp_last_bme68x_temperature) / 100;
     return value;
   } else {
     // get random value as temperature
-    std::cout << ">> RND " << "\n";
+    Logger().Log([]() { return std::string{">> RND \n"}; });
     static bool seed = (std::srand(std::time(nullptr)), true);
     (void)seed;
     static float last_value = 20.F;